@@ -0,0 +1,115 @@
+#!/bin/sh
+# build.sh - Build every program and test warning-clean, then run the tests.
+#
+# Usage: ./build.sh [--no-test]
+#
+# Every target is compiled with -Wall -Wextra -Werror (C++20). Targets that need
+# Crypto++ or libsecp256k1 are skipped, with a note, when their headers are not
+# found. The tests only use the header-only code, and each one runs once per
+# CPU dispatch level so the scalar and every SIMD kernel are checked.
+#
+# Environment:
+#   CXX             compiler (default g++)
+#   CXXFLAGS        optimization/target flags (default -O2 -march=native)
+#   CPPFLAGS        extra include paths, e.g. for Crypto++ or libsecp256k1
+#   LDFLAGS         extra library paths
+#   CRYPTOPP_LIBS   Crypto++ link flags (default -lcryptopp)
+#   SECP256K1_LIBS  libsecp256k1 link flags (default -lsecp256k1)
+#   BUILD_DIR       output directory (default build)
+
+set -eu
+
+cd "$(dirname "$0")"
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2 -march=native}
+CPPFLAGS=${CPPFLAGS:-}
+LDFLAGS=${LDFLAGS:-}
+CRYPTOPP_LIBS=${CRYPTOPP_LIBS--lcryptopp}
+SECP256K1_LIBS=${SECP256K1_LIBS--lsecp256k1}
+BUILD_DIR=${BUILD_DIR:-build}
+WARNINGS="-Wall -Wextra -Werror"
+
+runTests=1
+if [ "${1:-}" = "--no-test" ]; then
+    runTests=0
+fi
+
+mkdir -p "$BUILD_DIR"
+failed=0
+
+# have_header <header>: whether the compiler finds <header> with the current CPPFLAGS.
+have_header() {
+    echo "#include <$1>" | $CXX -std=c++20 $CPPFLAGS -E -x c++ - >/dev/null 2>&1
+}
+
+# build <name> <source> [libs...]
+build() {
+    name=$1
+    source=$2
+    shift 2
+    echo "build $name"
+    # shellcheck disable=SC2086 # flag variables are intentionally word-split
+    if ! $CXX -std=c++20 $CXXFLAGS $WARNINGS -pthread $CPPFLAGS "$source" -o "$BUILD_DIR/$name" $LDFLAGS "$@"; then
+        echo "FAILED $name" >&2
+        failed=1
+    fi
+}
+
+skip() {
+    echo "skip  $1 ($2 not found; set CPPFLAGS)"
+}
+
+# Header-only programs.
+build keccak_public_key_utility src/keccak_public_key_utility.cpp
+build keccak_daemon src/keccak_daemon.cpp
+build batch_validation src/hash_validation/batch_validation.cpp
+build LUT_validation src/hash_validation/LUT_validation.cpp
+build bitwise_validation src/hash_validation/bitwise_validation.cpp
+build keccak_hash_validation src/hash_validation/keccak_hash_validation.cpp
+
+# Programs with external dependencies. The benchmark compares against Crypto++ when present.
+if have_header cryptopp/keccak.h; then
+    # shellcheck disable=SC2086
+    build compute_keccak_hash src/compute_keccak_hash.cpp $CRYPTOPP_LIBS
+    # shellcheck disable=SC2086
+    build benchmark src/benchmarks/benchmark.cpp $CRYPTOPP_LIBS
+else
+    skip compute_keccak_hash "cryptopp/keccak.h"
+    build benchmark src/benchmarks/benchmark.cpp
+fi
+if have_header secp256k1_recovery.h; then
+    # shellcheck disable=SC2086
+    build ecrecover_batch src/ecrecover_batch.cpp $SECP256K1_LIBS
+else
+    skip ecrecover_batch "secp256k1_recovery.h"
+fi
+
+# Known-answer tests.
+tests=""
+for source in tests/*_test.cpp; do
+    name=$(basename "$source" .cpp)
+    build "$name" "$source"
+    tests="$tests $name"
+done
+
+if [ "$failed" -ne 0 ]; then
+    echo "build failed" >&2
+    exit 1
+fi
+if [ "$runTests" -eq 0 ]; then
+    exit 0
+fi
+
+for name in $tests; do
+    for level in scalar ssse3 avx2 avx512; do
+        if ! KECCAK_CPU_LEVEL=$level "$BUILD_DIR/$name"; then
+            failed=1
+        fi
+    done
+done
+if [ "$failed" -ne 0 ]; then
+    echo "tests failed" >&2
+    exit 1
+fi
+echo "all tests passed"
@@ -0,0 +1,519 @@
+// Benchmarks for the hash, hex, EIP-55, derivation and validation paths.
+//
+// Usage: benchmark [name-filter...]
+//   Runs every benchmark whose name contains one of the filters (all when none are given)
+//   and prints one JSON document to stdout: ns/op, cycles/op and cycles/byte from
+//   perf_event_open (null where the kernel or sandbox does not allow it), and heap
+//   allocations per op counted by the replaced global operator new.
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <new>
+#include <optional>
+#include <random>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if __has_include(<cryptopp/keccak.h>)
+#include <cryptopp/keccak.h>
+#define BENCHMARK_HAVE_CRYPTOPP 1
+#else
+#define BENCHMARK_HAVE_CRYPTOPP 0
+#endif
+
+#include "../hash_validation/LUT_validation.h"
+#include "../hash_validation/bitwise_validation.h"
+#include "../hash_validation/keccak_hash_validation.h"
+#include "../hash_validation/batch_validation.h"
+#include "../eth/address_utils.h"
+#include "../eth/address_batcher.h"
+#include "../eth/watchlist.h"
+
+// ---- Allocation counting ----
+
+static std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const size_t align = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC pairs free() with the library operator new when inlining and warns; these pointers
+// come from the malloc-based replacements above.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// ---- Cycle counting ----
+
+// User-space CPU cycles of this process and the threads it creates later, via perf_event_open.
+class CycleCounter {
+public:
+    CycleCounter() {
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CycleCounter() {
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    bool available() const noexcept { return fd_ >= 0; }
+
+    void start() noexcept {
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    std::optional<uint64_t> stop() noexcept {
+#if defined(__linux__)
+        uint64_t cycles = 0;
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &cycles, sizeof(cycles)) == static_cast<ssize_t>(sizeof(cycles))) {
+                return cycles;
+            }
+        }
+#endif
+        return std::nullopt;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// ---- Harness ----
+
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    size_t bytesPerOp;
+    size_t threads;
+    uint64_t iterations;
+    double nsPerOp;
+    std::optional<double> cyclesPerOp;
+    double allocationsPerOp;
+};
+
+class Runner {
+public:
+    explicit Runner(std::vector<std::string> filters) : filters_(std::move(filters)) {}
+
+    /**
+     * Time `body`, which performs `opsPerCall` operations of `bytesPerOp` bytes each.
+     * The call count is doubled until one repetition takes at least 20 ms; the fastest of
+     * five repetitions is reported, with the cycle count of that same repetition.
+     */
+    template <typename Body>
+    void run(const std::string& name, size_t bytesPerOp, size_t opsPerCall, size_t threads, Body&& body) {
+        if (!selected(name)) {
+            return;
+        }
+        using Clock = std::chrono::steady_clock;
+        body(); // warm-up: first-touch, lazy dispatch, thread start-up
+        uint64_t calls = 1;
+        while (true) {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < calls; ++i) {
+                body();
+            }
+            if (Clock::now() - start >= std::chrono::milliseconds(20) || calls >= (1ull << 40)) {
+                break;
+            }
+            calls *= 2;
+        }
+
+        double bestNs = 0;
+        std::optional<uint64_t> bestCycles;
+        const uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        constexpr int repetitions = 5;
+        for (int r = 0; r < repetitions; ++r) {
+            cycles_.start();
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < calls; ++i) {
+                body();
+            }
+            const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            const auto cycles = cycles_.stop();
+            if (r == 0 || ns < bestNs) {
+                bestNs = ns;
+                bestCycles = cycles;
+            }
+        }
+        const uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+        const double ops = static_cast<double>(calls * opsPerCall);
+        Result result{ name, bytesPerOp, threads, calls * opsPerCall, bestNs / ops, std::nullopt,
+                       static_cast<double>(allocations) / (ops * repetitions) };
+        if (bestCycles) {
+            result.cyclesPerOp = static_cast<double>(*bestCycles) / ops;
+        }
+        results_.push_back(result);
+        std::cerr << name << ": " << result.nsPerOp << " ns/op\n";
+    }
+
+    void printJson(std::ostream& out) const {
+        out << "{\n  \"context\": {\n";
+        out << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"cycle_counter\": " << (cycles_.available() ? "true" : "false") << ",\n";
+        out << "    \"keccak_multibuffer_width\": " << keccak256MultiBufferWidth() << ",\n";
+        out << "    \"dispatch\": ";
+        cpu::writeReport(out);
+        out << ",\n";
+        out << "    \"cryptopp\": " << (BENCHMARK_HAVE_CRYPTOPP ? "true" : "false") << ",\n";
+#if defined(__clang__)
+        out << "    \"compiler\": \"clang " << __clang_major__ << '.' << __clang_minor__ << "\"\n";
+#elif defined(__GNUC__)
+        out << "    \"compiler\": \"gcc " << __GNUC__ << '.' << __GNUC_MINOR__ << "\"\n";
+#else
+        out << "    \"compiler\": \"unknown\"\n";
+#endif
+        out << "  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const Result& r = results_[i];
+            out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\", \"threads\": " << r.threads
+                << ", \"bytes_per_op\": " << r.bytesPerOp << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << r.nsPerOp << ", \"cycles_per_op\": ";
+            if (r.cyclesPerOp) {
+                out << *r.cyclesPerOp << ", \"cycles_per_byte\": ";
+                if (r.bytesPerOp) {
+                    out << *r.cyclesPerOp / static_cast<double>(r.bytesPerOp);
+                } else {
+                    out << "null";
+                }
+            } else {
+                out << "null, \"cycles_per_byte\": null";
+            }
+            out << ", \"allocations_per_op\": " << r.allocationsPerOp << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    bool selected(const std::string& name) const {
+        if (filters_.empty()) {
+            return true;
+        }
+        for (const auto& filter : filters_) {
+            if (name.find(filter) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::string> filters_;
+    CycleCounter cycles_;
+    std::vector<Result> results_;
+};
+
+// ---- Inputs ----
+
+static std::vector<uint8_t> randomBytes(size_t size, std::mt19937_64& rng) {
+    std::vector<uint8_t> bytes(size);
+    for (auto& b : bytes) {
+        b = static_cast<uint8_t>(rng());
+    }
+    return bytes;
+}
+
+// Candidate hash strings in a realistic mix: mostly well-formed (with and without prefix,
+// either case), plus wrong lengths, a single bad digit and short garbage.
+static std::vector<std::string> validationMix(size_t count, std::mt19937_64& rng) {
+    static constexpr char lower[] = "0123456789abcdef";
+    static constexpr char upper[] = "0123456789ABCDEF";
+    std::vector<std::string> mix;
+    mix.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string s;
+        const unsigned kind = static_cast<unsigned>(rng() % 10);
+        const char* digits = (kind == 2 || kind == 3) ? upper : lower;
+        for (int j = 0; j < 64; ++j) {
+            s.push_back(digits[rng() % 16]);
+        }
+        if (kind < 5) {
+            s.insert(0, "0x");                      // 50%: valid, prefixed
+        } else if (kind == 6) {
+            s.resize(63);                           // 10%: one digit short
+        } else if (kind == 7) {
+            s[rng() % 64] = 'g';                    // 10%: one bad digit
+        } else if (kind == 8) {
+            s = "0x1234";                           // 10%: short garbage
+        }                                           // 20%: valid, unprefixed
+        mix.push_back(std::move(s));
+    }
+    return mix;
+}
+
+// ---- Benchmarks ----
+
+static void benchKeccak(Runner& runner, std::mt19937_64& rng) {
+    for (size_t size : { size_t(32), size_t(64), size_t(136), size_t(1024), size_t(1) << 20 }) {
+        const auto input = randomBytes(size, rng);
+        uint8_t digest[32];
+        const std::string suffix = "/" + std::to_string(size);
+        runner.run("keccak256/intree" + suffix, size, 1, 1, [&] {
+            keccak256(input.data(), input.size(), digest);
+            doNotOptimize(digest);
+        });
+#if BENCHMARK_HAVE_CRYPTOPP
+        CryptoPP::Keccak_256 cryptopp;
+        runner.run("keccak256/cryptopp" + suffix, size, 1, 1, [&] {
+            cryptopp.CalculateDigest(digest, input.data(), input.size());
+            doNotOptimize(digest);
+        });
+#endif
+    }
+
+    const auto input = randomBytes(64, rng);
+    uint8_t digest[32];
+    runner.run("keccak256/fixed64", 64, 1, 1, [&] {
+        keccak256Fixed<64>(input.data(), digest);
+        doNotOptimize(digest);
+    });
+
+    constexpr size_t lanes = 64;
+    const auto messages = randomBytes(64 * lanes, rng);
+    std::vector<uint8_t> digests(32 * lanes);
+    std::array<const uint8_t*, lanes> in;
+    std::array<uint8_t*, lanes> out;
+    for (size_t i = 0; i < lanes; ++i) {
+        in[i] = messages.data() + 64 * i;
+        out[i] = digests.data() + 32 * i;
+    }
+    runner.run("keccak256/multibuffer64", 64, lanes, 1, [&] {
+        keccak256MultiBuffer(in.data(), 64, out.data(), lanes);
+        doNotOptimize(digests);
+    });
+}
+
+static void benchHex(Runner& runner, std::mt19937_64& rng) {
+    for (size_t size : { size_t(20), size_t(32), size_t(64), size_t(4096) }) {
+        const auto bytes = randomBytes(size, rng);
+        std::vector<char> hex(2 * size + 1);
+        eth::bytesToHex(bytes.data(), bytes.size(), hex.data());
+        const std::string text(hex.data(), 2 * size);
+        const std::string suffix = "/" + std::to_string(size);
+        runner.run("bytesToHex" + suffix, size, 1, 1, [&] {
+            eth::bytesToHex(bytes.data(), bytes.size(), hex.data());
+            doNotOptimize(hex);
+        });
+        runner.run("hexToBytes" + suffix, 2 * size, 1, 1, [&] {
+            auto decoded = eth::hexToBytes(text);
+            doNotOptimize(decoded);
+        });
+        std::vector<eth::Byte> decoded(size);
+        runner.run("hexDecode" + suffix, 2 * size, 1, 1, [&] {
+            const bool ok = eth::hexDecode(text.data(), text.size(), decoded.data());
+            doNotOptimize(ok);
+            doNotOptimize(decoded);
+        });
+    }
+}
+
+static void benchAddresses(Runner& runner, std::mt19937_64& rng) {
+    const auto key = randomBytes(64, rng);
+    const std::vector<eth::Byte> publicKey(key.begin(), key.end());
+    char address[43];
+    eth::deriveEthereumAddress(publicKey, address);
+    const std::string lowercase = [&] {
+        std::string s(address);
+        for (auto& c : s) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return s;
+    }();
+
+    runner.run("toEIP55Address", 40, 1, 1, [&] {
+        std::memcpy(address, lowercase.c_str(), 43);
+        eth::toEIP55Address(address);
+        doNotOptimize(address);
+    });
+    runner.run("deriveEthereumAddress", 64, 1, 1, [&] {
+        eth::deriveEthereumAddress(publicKey, address);
+        doNotOptimize(address);
+    });
+    runner.run("deriveEthereumAddress/raw", 64, 1, 1, [&] {
+        doNotOptimize(eth::deriveEthereumAddress(publicKey));
+    });
+
+    constexpr size_t batch = 1 << 14;
+    std::vector<std::vector<eth::Byte>> keys(batch);
+    std::vector<eth::PublicKeyBytes> packed(batch);
+    for (size_t i = 0; i < batch; ++i) {
+        keys[i] = randomBytes(64, rng);
+        std::memcpy(packed[i].data(), keys[i].data(), 64);
+    }
+    std::vector<std::array<char, 43>> addresses(batch);
+    std::vector<eth::AddressBytes> raw(batch);
+
+    const size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t t = 1; t < maxThreads; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+    for (size_t threads : threadCounts) {
+        eth::ThreadPool pool(eth::ThreadPool::Options{ threads, false });
+        const std::string suffix = "/threads:" + std::to_string(threads);
+        runner.run("deriveMultipleAddresses" + suffix, 64, batch, threads, [&] {
+            eth::deriveMultipleAddresses(keys, addresses, pool);
+            doNotOptimize(addresses);
+        });
+        runner.run("deriveAddresses/packed" + suffix, 64, batch, threads, [&] {
+            eth::deriveAddresses(packed, raw, pool);
+            doNotOptimize(raw);
+        });
+    }
+
+    // Single-key requests through the micro-batcher: one caller keeps `inFlight` futures
+    // outstanding, so batches fill to maxBatch instead of waiting out maxWait.
+    constexpr size_t inFlight = 1024;
+    eth::AddressBatcher batcher(eth::AddressBatcher::Options{ 256, std::chrono::microseconds(50), nullptr, nullptr });
+    std::vector<std::future<eth::DerivedAddress>> futures(inFlight);
+    runner.run("AddressBatcher/submit", 64, inFlight, 1, [&] {
+        for (size_t i = 0; i < inFlight; ++i) {
+            futures[i] = batcher.submit(packed[i]);
+        }
+        for (auto& future : futures) {
+            doNotOptimize(future.get());
+        }
+    });
+    std::atomic<size_t> completed{0};
+    runner.run("AddressBatcher/callback", 64, inFlight, 1, [&] {
+        const size_t target = completed.load(std::memory_order_relaxed) + inFlight;
+        for (size_t i = 0; i < inFlight; ++i) {
+            batcher.submit(packed[i], [&](const eth::DerivedAddress&, std::exception_ptr) {
+                completed.fetch_add(1, std::memory_order_release);
+            });
+        }
+        while (completed.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+    });
+
+    // Watchlist lookups: a million random watched addresses, probed with the (unwatched)
+    // derived batch, so nearly every probe is rejected by the Bloom filter.
+    std::vector<eth::Address> watched(1 << 20);
+    for (auto& address : watched) {
+        const auto bytes = randomBytes(20, rng);
+        address = eth::Address::fromBytes(bytes.data());
+    }
+    const eth::Watchlist watchlist(watched);
+    std::vector<eth::Address> candidates(batch);
+    eth::deriveAddresses(packed, candidates);
+    std::vector<size_t> hits(batch);
+    runner.run("Watchlist/matchBatch", 20, batch, 1, [&] {
+        doNotOptimize(watchlist.matchBatch(candidates, hits.data()));
+    });
+    runner.run("Watchlist/contains", 20, batch, 1, [&] {
+        size_t found = 0;
+        for (const auto& address : candidates) {
+            found += watchlist.contains(address);
+        }
+        doNotOptimize(found);
+    });
+}
+
+static void benchValidation(Runner& runner, std::mt19937_64& rng) {
+    constexpr size_t count = 4096;
+    const auto mix = validationMix(count, rng);
+    size_t bytes = 0;
+    for (const auto& s : mix) {
+        bytes += s.size();
+    }
+    const size_t bytesPerOp = bytes / count;
+
+    auto runValidator = [&](const std::string& name, bool (*isKeccak256)(const std::string&)) {
+        runner.run("isKeccak256/" + name, bytesPerOp, count, 1, [&] {
+            size_t valid = 0;
+            for (const auto& s : mix) {
+                valid += isKeccak256(s);
+            }
+            doNotOptimize(valid);
+        });
+    };
+    runValidator("lut", &lut_validation::isKeccak256);
+    runValidator("bitwise", &bitwise_validation::isKeccak256);
+    runValidator("naive", &naive_validation::isKeccak256);
+
+    constexpr size_t stride = 72;
+    std::vector<char> packed(count * stride, '\0');
+    for (size_t i = 0; i < count; ++i) {
+        std::memcpy(packed.data() + i * stride, mix[i].data(), std::min(mix[i].size(), stride));
+    }
+    std::vector<uint64_t> results((count + 63) / 64);
+    eth::ThreadPool single(eth::ThreadPool::Options{ 1, false });
+    runner.run("isKeccak256/batch", bytesPerOp, count, 1, [&] {
+        hash_validation::validateHexStrings(packed.data(), count, stride, results.data(), single);
+        doNotOptimize(results);
+    });
+}
+
+int main(int argc, char* argv[]) {
+    Runner runner(std::vector<std::string>(argv + 1, argv + argc));
+    std::mt19937_64 rng(0x6b656363616bULL);
+    benchKeccak(runner, rng);
+    benchHex(runner, rng);
+    benchAddresses(runner, rng);
+    benchValidation(runner, rng);
+    runner.printJson(std::cout);
+    return 0;
+}
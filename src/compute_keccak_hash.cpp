@@ -1,12 +1,641 @@
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <cryptopp/keccak.h>
 #include <cryptopp/hex.h>
 #include <cryptopp/filters.h>
+#include "keccak/keccak.h"
+#include "eth/hex.h"
+#include "eth/storage_slots.h"
+#include "eth/thread_pool.h"
 
 using namespace CryptoPP;
 
-int main() {
+// Chunk size for read()-based hashing: a multiple of the Keccak-256 rate, so every
+// chunk is absorbed straight from the read buffer without partial-block buffering.
+constexpr size_t READ_CHUNK_SIZE = KECCAK256_RATE * 30840; // ~4 MiB
+constexpr size_t READ_CHUNK_ALIGNMENT = 4096;
+
+// Hash a regular file through a read-only mapping, hinting the kernel to read ahead.
+// Returns false if the file cannot be mapped, so the caller can fall back to read().
+static bool hashMapped(int fd, size_t size, Keccak256& keccak) {
+    if (size == 0) {
+        return true;
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    keccak.Update(static_cast<const uint8_t*>(mapping), size);
+    munmap(mapping, size);
+    return true;
+}
+
+// Hash any readable descriptor in large, page-aligned chunks. Returns bytes hashed, or -1 on error.
+static long long hashChunked(int fd, Keccak256& keccak) {
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    void* buffer = nullptr;
+    if (posix_memalign(&buffer, READ_CHUNK_ALIGNMENT, READ_CHUNK_SIZE) != 0) {
+        return -1;
+    }
+    auto* chunk = static_cast<uint8_t*>(buffer);
+    long long total = 0;
+    bool eof = false;
+    while (!eof) {
+        // Fill the whole chunk (reads may return short) so Update stays block-aligned.
+        size_t filled = 0;
+        while (filled < READ_CHUNK_SIZE) {
+            ssize_t n = read(fd, chunk + filled, READ_CHUNK_SIZE - filled);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::free(buffer);
+                return -1;
+            }
+            if (n == 0) {
+                eof = true;
+                break;
+            }
+            filled += static_cast<size_t>(n);
+        }
+        keccak.Update(chunk, filled);
+        total += static_cast<long long>(filled);
+    }
+    std::free(buffer);
+    return total;
+}
+
+// Hash one file (or stdin for "-") and print "<digest>  <name>"; throughput goes to stderr.
+static bool hashFile(std::string_view path, bool useMmap) {
+    const bool isStdin = (path == "-");
+    int fd = isStdin ? STDIN_FILENO : open(std::string(path).c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: cannot open " << path << ": " << std::strerror(errno) << '\n';
+        return false;
+    }
+
+    Keccak256 keccak;
+    auto start = std::chrono::steady_clock::now();
+    long long bytes = -1;
+    struct stat info{};
+    if (useMmap && fstat(fd, &info) == 0 && S_ISREG(info.st_mode) &&
+        hashMapped(fd, static_cast<size_t>(info.st_size), keccak)) {
+        bytes = info.st_size;
+    } else {
+        bytes = hashChunked(fd, keccak);
+    }
+    const int readError = errno;
+    if (!isStdin) {
+        close(fd);
+    }
+    if (bytes < 0) {
+        std::cerr << "Error: failed reading " << path << ": " << std::strerror(readError) << '\n';
+        return false;
+    }
+
+    uint8_t digest[Keccak256::DIGESTSIZE];
+    keccak.Final(digest);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    char hex[2 * Keccak256::DIGESTSIZE];
+    eth::hexEncode(digest, sizeof(digest), hex);
+    std::cout.write(hex, sizeof(hex)) << "  " << path << '\n';
+    std::cerr << path << ": " << bytes << " bytes in " << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << " (" << (static_cast<double>(bytes) / seconds / 1e9) << " GB/s)";
+    }
+    std::cerr << '\n';
+    return true;
+}
+
+// Bounded blocking queue connecting the batch-mode pipeline stages.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    // Block while the queue is full, then enqueue.
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [&] { return items_.size() < capacity_; });
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+    }
+
+    // Block until an item is available; returns nullopt once closed and drained.
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [&] { return !items_.empty() || closed_; });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return item;
+    }
+
+    // Signal that no more items will be pushed.
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::deque<T> items_;
+    size_t capacity_;
+    bool closed_ = false;
+};
+
+// Batch-mode tuning: bytes requested per read() and blocks in flight per queue.
+constexpr size_t BATCH_READ_SIZE = 1 << 20;
+constexpr size_t BATCH_QUEUE_DEPTH = 8;
+
+// Reader stage: read large blocks and cut them after the last newline, so every
+// block handed on holds whole records. A final unterminated record is flushed at EOF.
+static bool readRecordBlocks(int fd, BoundedQueue<std::vector<char>>& blocks) {
+    std::vector<char> pending;
+    bool ok = true;
+    while (true) {
+        std::vector<char> block(std::move(pending));
+        const size_t carried = block.size();
+        block.resize(carried + BATCH_READ_SIZE);
+        ssize_t n = read(fd, block.data() + carried, BATCH_READ_SIZE);
+        if (n < 0 && errno == EINTR) {
+            pending = std::move(block);
+            pending.resize(carried);
+            continue;
+        }
+        if (n <= 0) {
+            ok = (n == 0);
+            block.resize(carried);
+            if (!block.empty()) {
+                blocks.push(std::move(block));
+            }
+            break;
+        }
+        block.resize(carried + static_cast<size_t>(n));
+
+        size_t end = block.size();
+        while (end > carried && block[end - 1] != '\n') {
+            --end;
+        }
+        if (end == carried) {
+            // No record boundary in the new data yet; keep accumulating.
+            pending = std::move(block);
+            continue;
+        }
+        pending.assign(block.begin() + static_cast<std::ptrdiff_t>(end), block.end());
+        block.resize(end);
+        blocks.push(std::move(block));
+    }
+    blocks.close();
+    return ok;
+}
+
+// Records per parallelFor grain in batch mode.
+constexpr size_t BATCH_HASH_GRAIN = 512;
+
+// Hasher stage: hash every record of a block and format one lowercase digest line per record.
+// In hex mode records are decoded first (an optional 0x prefix is skipped); undecodable
+// records produce an "invalid" line so the output stays aligned with the input.
+// The records of a block are hashed on the pool's workers, each writing its fixed-size
+// lines in place, so the block's output stays in input order.
+static size_t hashRecordBlocks(BoundedQueue<std::vector<char>>& blocks, BoundedQueue<std::string>& lines,
+                               bool hexRecords, eth::ThreadPool& pool) {
+    constexpr size_t lineSize = 2 * Keccak256::DIGESTSIZE + 1;
+    std::vector<std::string_view> records;
+    std::vector<uint8_t> valid;
+    size_t invalid = 0;
+    while (auto block = blocks.pop()) {
+        records.clear();
+        const char* cursor = block->data();
+        const char* end = cursor + block->size();
+        while (cursor < end) {
+            const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+            const char* recordEnd = newline ? newline : end;
+            std::string_view record(cursor, static_cast<size_t>(recordEnd - cursor));
+            cursor = newline ? newline + 1 : end;
+            if (!record.empty() && record.back() == '\r') {
+                record.remove_suffix(1);
+            }
+            records.push_back(record);
+        }
+
+        const size_t count = records.size();
+        std::string out(count * lineSize, '\0');
+        valid.assign(count, 1);
+        pool.parallelFor(count, BATCH_HASH_GRAIN, [&](size_t begin, size_t stop) {
+            std::vector<uint8_t> decoded;
+            for (size_t i = begin; i < stop; ++i) {
+                std::string_view record = records[i];
+                const uint8_t* message = reinterpret_cast<const uint8_t*>(record.data());
+                size_t messageLength = record.size();
+                if (hexRecords) {
+                    if (record.size() >= 2 && record[0] == '0' && (record[1] == 'x' || record[1] == 'X')) {
+                        record.remove_prefix(2);
+                    }
+                    decoded.resize(record.size() / 2);
+                    if (!eth::hexDecode(record.data(), record.size(), decoded.data())) {
+                        valid[i] = 0;
+                        continue;
+                    }
+                    message = decoded.data();
+                    messageLength = decoded.size();
+                }
+                uint8_t digest[Keccak256::DIGESTSIZE];
+                keccak256(message, messageLength, digest);
+                char* line = out.data() + i * lineSize;
+                eth::hexEncode(digest, sizeof(digest), line);
+                line[lineSize - 1] = '\n';
+            }
+        });
+
+        // Replace the slots of undecodable records with shorter "invalid" lines.
+        if (std::find(valid.begin(), valid.end(), 0) != valid.end()) {
+            size_t at = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (!valid[i]) {
+                    std::memcpy(out.data() + at, "invalid\n", 8);
+                    at += 8;
+                    ++invalid;
+                    continue;
+                }
+                std::memmove(out.data() + at, out.data() + i * lineSize, lineSize);
+                at += lineSize;
+            }
+            out.resize(at);
+        }
+        lines.push(std::move(out));
+    }
+    lines.close();
+    return invalid;
+}
+
+// Writer stage: write formatted digest blocks in order, retrying short writes.
+static bool writeLineBlocks(int fd, BoundedQueue<std::string>& lines, size_t& records) {
+    bool ok = true;
+    while (auto text = lines.pop()) {
+        records += static_cast<size_t>(std::count(text->begin(), text->end(), '\n'));
+        const char* data = text->data();
+        size_t remaining = text->size();
+        while (ok && remaining > 0) {
+            ssize_t n = write(fd, data, remaining);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ok = false;
+                break;
+            }
+            data += n;
+            remaining -= static_cast<size_t>(n);
+        }
+    }
+    return ok;
+}
+
+// Hash newline-delimited records from a file (or stdin for "-") through a
+// reader -> hasher -> writer pipeline, writing one digest per line to stdout.
+// The hasher stage spreads each block over the shared thread pool.
+static bool hashRecords(std::string_view path, bool hexRecords) {
+    const bool isStdin = (path == "-");
+    int fd = isStdin ? STDIN_FILENO : open(std::string(path).c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: cannot open " << path << ": " << std::strerror(errno) << '\n';
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    BoundedQueue<std::vector<char>> blocks(BATCH_QUEUE_DEPTH);
+    BoundedQueue<std::string> lines(BATCH_QUEUE_DEPTH);
+    auto start = std::chrono::steady_clock::now();
+
+    bool readOk = true;
+    size_t invalid = 0;
+    std::thread reader([&] { readOk = readRecordBlocks(fd, blocks); });
+    std::thread hasher([&] { invalid = hashRecordBlocks(blocks, lines, hexRecords, eth::ThreadPool::shared()); });
+    size_t records = 0;
+    const bool writeOk = writeLineBlocks(STDOUT_FILENO, lines, records);
+    if (!writeOk) {
+        // Keep draining so the upstream stages can finish.
+        while (lines.pop()) {
+        }
+    }
+    reader.join();
+    hasher.join();
+    if (!isStdin) {
+        close(fd);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << path << ": " << records << " records in " << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << " (" << static_cast<size_t>(static_cast<double>(records) / seconds) << " records/s)";
+    }
+    if (invalid > 0) {
+        std::cerr << ", " << invalid << " invalid hex records";
+    }
+    std::cerr << '\n';
+    if (!readOk || !writeOk) {
+        std::cerr << "Error: I/O failure in batch mode\n";
+    }
+    return readOk && writeOk && invalid == 0;
+}
+
+// Keys per storage-slot batch.
+constexpr size_t SLOT_BATCH = 1 << 16;
+
+struct SlotQuery {
+    eth::Word base{};          // slot of the mapping or array, outer keys already applied
+    bool array = false;        // keys are element indices of a dynamic array at `base`
+    uint64_t slotsPerElement = 1;
+    bool packedInput = false;  // 32-byte words instead of text lines
+    bool rawOutput = false;    // 32-byte slots instead of hex lines
+};
+
+// Write the whole buffer, retrying short and interrupted writes.
+static bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Compute and write the slots of one batch. `wellFormed` may be nullptr when every key parsed.
+static bool writeSlotBatch(const SlotQuery& query, const std::vector<eth::Word>& keys, size_t count,
+                           const uint8_t* wellFormed, std::vector<eth::Word>& slots) {
+    std::span<const eth::Word> in(keys.data(), count);
+    std::span<eth::Word> out(slots.data(), count);
+    if (query.array) {
+        eth::arrayElementSlots(query.base, in, out, query.slotsPerElement);
+    } else {
+        eth::mappingSlots(query.base, in, out);
+    }
+    std::string text;
+    if (query.rawOutput) {
+        text.resize(count * sizeof(eth::Word));
+        for (size_t i = 0; i < count; ++i) {
+            if (wellFormed && !wellFormed[i]) {
+                slots[i] = {};
+            }
+            std::memcpy(&text[i * sizeof(eth::Word)], slots[i].data(), sizeof(eth::Word));
+        }
+    } else {
+        constexpr size_t lineSize = 2 + 2 * sizeof(eth::Word) + 1;
+        text.reserve(count * lineSize);
+        for (size_t i = 0; i < count; ++i) {
+            if (wellFormed && !wellFormed[i]) {
+                text.append("invalid\n");
+                continue;
+            }
+            const size_t at = text.size();
+            text.resize(at + lineSize);
+            text[at] = '0';
+            text[at + 1] = 'x';
+            eth::hexEncode(slots[i].data(), sizeof(eth::Word), text.data() + at + 2);
+            text[at + lineSize - 1] = '\n';
+        }
+    }
+    return writeAll(STDOUT_FILENO, text.data(), text.size());
+}
+
+// Storage-slot mode: one slot per key (or array index) read from a file or stdin.
+// Text keys are decimal or 0x-hex, one per line; unparsable lines produce "invalid".
+static bool computeSlots(std::string_view path, const SlotQuery& query) {
+    const bool isStdin = (path == "-");
+    int fd = isStdin ? STDIN_FILENO : open(std::string(path).c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: cannot open " << path << ": " << std::strerror(errno) << '\n';
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    std::vector<eth::Word> keys(SLOT_BATCH);
+    std::vector<eth::Word> slots(SLOT_BATCH);
+    std::vector<uint8_t> wellFormed(SLOT_BATCH);
+    auto start = std::chrono::steady_clock::now();
+    size_t records = 0;
+    size_t invalid = 0;
+    bool ok = true;
+
+    if (query.packedInput) {
+        size_t filled = 0;
+        const size_t capacity = keys.size() * sizeof(eth::Word);
+        auto* buffer = reinterpret_cast<char*>(keys.data());
+        while (ok) {
+            ssize_t n = read(fd, buffer + filled, capacity - filled);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                std::cerr << "Error: failed reading " << path << ": " << std::strerror(errno) << '\n';
+                ok = false;
+                break;
+            }
+            filled += static_cast<size_t>(n);
+            if (n == 0 || filled == capacity) {
+                const size_t count = filled / sizeof(eth::Word);
+                ok = count == 0 || writeSlotBatch(query, keys, count, nullptr, slots);
+                records += count;
+                if (n == 0) {
+                    if (filled % sizeof(eth::Word) != 0) {
+                        std::cerr << "Warning: ignoring " << filled % sizeof(eth::Word)
+                                  << " trailing bytes (incomplete key)\n";
+                    }
+                    break;
+                }
+                filled = 0;
+            }
+        }
+    } else {
+        std::vector<char> buffer(BATCH_READ_SIZE);
+        std::string line;
+        size_t count = 0;
+        bool eof = false;
+        auto flush = [&] {
+            ok = ok && writeSlotBatch(query, keys, count, wellFormed.data(), slots);
+            records += count;
+            count = 0;
+        };
+        auto addLine = [&](std::string_view text) {
+            if (!text.empty() && text.back() == '\r') {
+                text.remove_suffix(1);
+            }
+            wellFormed[count] = eth::parseWord(text, keys[count]);
+            invalid += !wellFormed[count];
+            if (++count == SLOT_BATCH) {
+                flush();
+            }
+        };
+        while (ok && !eof) {
+            ssize_t n = read(fd, buffer.data(), buffer.size());
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                std::cerr << "Error: failed reading " << path << ": " << std::strerror(errno) << '\n';
+                ok = false;
+                break;
+            }
+            eof = (n == 0);
+            const char* cursor = buffer.data();
+            const char* end = cursor + n;
+            while (cursor < end) {
+                const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+                if (!newline) {
+                    line.append(cursor, end);
+                    break;
+                }
+                if (line.empty()) {
+                    addLine(std::string_view(cursor, static_cast<size_t>(newline - cursor)));
+                } else {
+                    line.append(cursor, newline);
+                    addLine(line);
+                    line.clear();
+                }
+                cursor = newline + 1;
+            }
+        }
+        if (ok && !line.empty()) {
+            addLine(line);
+        }
+        if (count > 0) {
+            flush();
+        }
+    }
+    if (!isStdin) {
+        close(fd);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << path << ": " << records << " slots in " << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << " (" << static_cast<size_t>(static_cast<double>(records) / seconds) << " slots/s)";
+    }
+    if (invalid > 0) {
+        std::cerr << ", " << invalid << " invalid keys";
+    }
+    std::cerr << '\n';
+    if (!ok) {
+        std::cerr << "Error: I/O failure in slot mode\n";
+    }
+    return ok && invalid == 0;
+}
+
+int main(int argc, char* argv[]) {
+    // File mode:  compute_keccak_hash [--read] <file|->...
+    // Batch mode: compute_keccak_hash --batch [--hex] [file|-]
+    // Slot mode:  compute_keccak_hash --slot <n> [--key <k>]... [--array [--element-slots <n>]]
+    //                                 [--packed] [--raw] [file|-]
+    //   Storage slots of mapping[key] (or array[index] with --array) for every key read,
+    //   where --key applies outer mapping keys first: --slot 3 --key A reads m[A][key].
+    if (argc > 1) {
+        bool useMmap = true;
+        bool batch = false;
+        bool hexRecords = false;
+        bool slotMode = false;
+        SlotQuery query;
+        std::vector<eth::Word> outerKeys;
+        bool ok = true;
+        bool hashedAny = false;
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if ((arg == "--slot" || arg == "--key" || arg == "--element-slots") && i + 1 < argc) {
+                eth::Word word;
+                if (!eth::parseWord(argv[++i], word)) {
+                    std::cerr << "Error: invalid value for " << arg << ": " << argv[i] << '\n';
+                    return 1;
+                }
+                if (arg == "--slot") {
+                    query.base = word;
+                    slotMode = true;
+                } else if (arg == "--key") {
+                    outerKeys.push_back(word);
+                } else {
+                    if (std::any_of(word.begin(), word.begin() + 24, [](eth::Byte b) { return b != 0; })) {
+                        std::cerr << "Error: --element-slots out of range: " << argv[i] << '\n';
+                        return 1;
+                    }
+                    query.slotsPerElement = 0;
+                    for (size_t b = 24; b < word.size(); ++b) {
+                        query.slotsPerElement = (query.slotsPerElement << 8) | word[b];
+                    }
+                }
+            } else if (arg == "--slot" || arg == "--key" || arg == "--element-slots") {
+                std::cerr << "Error: missing value for " << arg << '\n';
+                return 1;
+            } else if (arg == "--array") {
+                query.array = true;
+            } else if (arg == "--packed") {
+                query.packedInput = true;
+            } else if (arg == "--raw") {
+                query.rawOutput = true;
+            } else if (arg.starts_with("--") &&
+                       (slotMode || (arg != "--read" && arg != "--batch" && arg != "--hex"))) {
+                // Never treat a mistyped or misplaced option as a file name.
+                std::cerr << "Error: unknown option: " << arg << '\n';
+                return 1;
+            } else if (slotMode) {
+                query.base = eth::nestedMappingSlot(outerKeys, query.base);
+                outerKeys.clear();
+                ok &= computeSlots(arg, query);
+                hashedAny = true;
+            } else if (arg == "--read") {
+                useMmap = false;
+            } else if (arg == "--batch") {
+                batch = true;
+            } else if (arg == "--hex") {
+                hexRecords = true;
+            } else {
+                ok &= batch ? hashRecords(arg, hexRecords) : hashFile(arg, useMmap);
+                hashedAny = true;
+            }
+        }
+        if (slotMode && !hashedAny) {
+            query.base = eth::nestedMappingSlot(outerKeys, query.base);
+            ok &= computeSlots("-", query);
+        } else if (batch && !hashedAny) {
+            ok &= hashRecords("-", hexRecords);
+        }
+        return ok ? 0 : 1;
+    }
+
     // Prompt the user to enter a string
     std::cout << "Enter the string to hash: ";
     std::string input;
@@ -31,4 +660,4 @@ int main() {
     std::cout << "Keccak-256 hash: " << output << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,192 @@
+// cpu_dispatch.h - One-time CPU feature probe, override and kernel selection report
+//
+// Every SIMD dispatcher in the tree (multi-buffer Keccak, hex codec, hash-string
+// validator) asks cpu::supports() instead of probing CPUID itself, so one
+// environment variable can cap them all, and each records the kernel it bound
+// with cpu::recordSelection() so a binary can report what it is running.
+//
+//   KECCAK_CPU_LEVEL=scalar|ssse3|avx2|avx512   highest instruction set to use
+//
+// An unset or unrecognised value means "best available". The override can only
+// lower the level; it never enables instructions the CPU lacks.
+
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CPU_DISPATCH_X86 1
+#else
+#define CPU_DISPATCH_X86 0
+#endif
+
+namespace cpu {
+
+    // Instruction-set tiers, in increasing order. Kernels are grouped by the tier they need.
+    enum class Level : uint8_t {
+        Scalar = 0,
+        SSSE3 = 1,
+        AVX2 = 2,
+        AVX512 = 3,
+    };
+
+    // Individual features the kernels test for.
+    enum class Feature : uint8_t {
+        SSSE3,
+        AVX2,
+        AVX512F,
+        AVX512BW,
+    };
+
+    inline const char* levelName(Level level) noexcept {
+        switch (level) {
+            case Level::Scalar: return "scalar";
+            case Level::SSSE3: return "ssse3";
+            case Level::AVX2: return "avx2";
+            case Level::AVX512: return "avx512";
+        }
+        return "unknown";
+    }
+
+    namespace detail {
+
+        inline constexpr const char* LEVEL_ENV = "KECCAK_CPU_LEVEL";
+
+        // Tier a feature belongs to, for comparison against the override.
+        constexpr Level featureLevel(Feature feature) noexcept {
+            switch (feature) {
+                case Feature::SSSE3: return Level::SSSE3;
+                case Feature::AVX2: return Level::AVX2;
+                case Feature::AVX512F:
+                case Feature::AVX512BW: return Level::AVX512;
+            }
+            return Level::AVX512;
+        }
+
+        struct Probe {
+            bool ssse3 = false;
+            bool avx2 = false;
+            bool avx512f = false;
+            bool avx512bw = false;
+            Level cap = Level::AVX512;
+        };
+
+        inline Level parseLevel(std::string_view value, Level fallback) noexcept {
+            if (value == "scalar") return Level::Scalar;
+            if (value == "ssse3") return Level::SSSE3;
+            if (value == "avx2") return Level::AVX2;
+            if (value == "avx512") return Level::AVX512;
+            return fallback;
+        }
+
+        // CPUID and the environment are read once, on first use.
+        inline const Probe& probe() noexcept {
+            static const Probe result = [] {
+                Probe p;
+#if CPU_DISPATCH_X86
+                __builtin_cpu_init();
+                p.ssse3 = __builtin_cpu_supports("ssse3");
+                p.avx2 = __builtin_cpu_supports("avx2");
+                p.avx512f = __builtin_cpu_supports("avx512f");
+                p.avx512bw = __builtin_cpu_supports("avx512bw");
+#endif
+                if (const char* value = std::getenv(LEVEL_ENV)) {
+                    p.cap = parseLevel(value, Level::AVX512);
+                }
+                return p;
+            }();
+            return result;
+        }
+
+        struct Selection {
+            const char* component;
+            const char* kernel;
+        };
+
+        inline constexpr size_t MAX_SELECTIONS = 16;
+
+        struct Registry {
+            std::mutex mutex;
+            Selection entries[MAX_SELECTIONS];
+            size_t count = 0;
+        };
+
+        inline Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Whether a kernel needing `feature` may run: the CPU has it and the override allows it.
+     */
+    inline bool supports(Feature feature) noexcept {
+        const detail::Probe& p = detail::probe();
+        if (detail::featureLevel(feature) > p.cap) {
+            return false;
+        }
+        switch (feature) {
+            case Feature::SSSE3: return p.ssse3;
+            case Feature::AVX2: return p.avx2;
+            case Feature::AVX512F: return p.avx512f;
+            case Feature::AVX512BW: return p.avx512bw;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Highest tier allowed by KECCAK_CPU_LEVEL (avx512 when unset).
+     */
+    inline Level levelCap() noexcept {
+        return detail::probe().cap;
+    }
+
+    /**
+     * @brief Record the kernel a dispatcher bound, for selectedKernels reporting.
+     * @param component Stable name of the dispatch point (e.g. "hex").
+     * @param kernel Name of the chosen implementation (e.g. "avx2").
+     * @note Both strings must have static storage duration. A component recorded twice
+     *       keeps its first entry.
+     */
+    inline void recordSelection(const char* component, const char* kernel) {
+        detail::Registry& r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (size_t i = 0; i < r.count; ++i) {
+            if (std::string_view(r.entries[i].component) == component) {
+                return;
+            }
+        }
+        if (r.count < detail::MAX_SELECTIONS) {
+            r.entries[r.count++] = { component, kernel };
+        }
+    }
+
+    /**
+     * @brief Write the detected features, the override and every bound kernel as a JSON object.
+     * @note Only dispatchers that have been used (or bound at start-up) appear.
+     */
+    inline void writeReport(std::ostream& out) {
+        const detail::Probe& p = detail::probe();
+        out << "{\"features\": {\"ssse3\": " << (p.ssse3 ? "true" : "false")
+            << ", \"avx2\": " << (p.avx2 ? "true" : "false")
+            << ", \"avx512f\": " << (p.avx512f ? "true" : "false")
+            << ", \"avx512bw\": " << (p.avx512bw ? "true" : "false")
+            << "}, \"level_cap\": \"" << levelName(p.cap) << "\", \"kernels\": {";
+        detail::Registry& r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (size_t i = 0; i < r.count; ++i) {
+            out << (i ? ", " : "") << '"' << r.entries[i].component << "\": \"" << r.entries[i].kernel << '"';
+        }
+        out << "}}";
+    }
+
+} // namespace cpu
+
+#endif // CPU_DISPATCH_H
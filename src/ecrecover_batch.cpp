@@ -0,0 +1,243 @@
+// Batch ecrecover: recover sender addresses for many (hash, signature) records.
+//
+// Usage: ecrecover_batch [--hex] [--raw] [file|-]
+//   Binary input (default): packed 97-byte records, hash (32) || r (32) || s (32) || v (1).
+//   --hex: one record per line, 194 hex digits; fields may be split by spaces, tabs or
+//          commas and each may carry a 0x prefix (e.g. "0x<hash> 0x<signature>").
+//   Output: one line per record, the EIP-55 address or "error <status>", in input order.
+//   --raw:  21 bytes per record instead, a status byte followed by the 20-byte address.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include "eth/secp256k1_batch.h"
+#include "eth/hex.h"
+
+// Records recovered per batch. Recovery costs tens of microseconds per record, so a
+// modest batch already keeps every worker busy.
+constexpr size_t RECOVER_BATCH = 1 << 14;
+
+// Raw-output status byte for hex lines that do not decode to a record.
+constexpr uint8_t STATUS_MALFORMED_INPUT = 0xFF;
+
+// Write the whole buffer, retrying short and interrupted writes.
+static bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Fill the buffer from fd; returns bytes read (short only at end of input), or -1 on error.
+static long long readFull(int fd, void* buffer, size_t size) {
+    auto* out = static_cast<char*>(buffer);
+    size_t filled = 0;
+    while (filled < size) {
+        ssize_t n = read(fd, out + filled, size - filled);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        filled += static_cast<size_t>(n);
+    }
+    return static_cast<long long>(filled);
+}
+
+// Decode one hex line into a record; separators and per-field 0x prefixes are skipped.
+static bool parseRecordLine(std::string_view line, eth::RecoverRecord& record) noexcept {
+    char digits[2 * sizeof(eth::RecoverRecord)];
+    size_t count = 0;
+    size_t i = 0;
+    while (i < line.size()) {
+        const char c = line[i];
+        if (c == ' ' || c == '\t' || c == ',' || c == '\r') {
+            ++i;
+            continue;
+        }
+        if (c == '0' && i + 1 < line.size() && (line[i + 1] == 'x' || line[i + 1] == 'X') &&
+            (i == 0 || line[i - 1] == ' ' || line[i - 1] == '\t' || line[i - 1] == ',')) {
+            i += 2;
+            continue;
+        }
+        if (count == sizeof(digits)) {
+            return false;
+        }
+        digits[count++] = c;
+        ++i;
+    }
+    return count == sizeof(digits) &&
+           eth::hexDecode(digits, count, reinterpret_cast<eth::Byte*>(&record));
+}
+
+struct RecoverTotals {
+    size_t records = 0;
+    size_t failed = 0;
+};
+
+// Recover one batch and write its results. `wellFormed` may be nullptr when every record decoded.
+static bool recoverBatch(const std::vector<eth::RecoverRecord>& records, size_t count,
+                         const uint8_t* wellFormed, bool rawOutput, RecoverTotals& totals) {
+    std::vector<eth::AddressBytes> addresses(count);
+    std::vector<eth::RecoverStatus> status(count);
+    eth::recoverAddresses(std::span<const eth::RecoverRecord>(records.data(), count), addresses, status);
+
+    std::string out;
+    if (rawOutput) {
+        out.resize(count * 21);
+        for (size_t i = 0; i < count; ++i) {
+            const bool malformed = wellFormed && !wellFormed[i];
+            out[i * 21] = static_cast<char>(malformed ? STATUS_MALFORMED_INPUT : static_cast<uint8_t>(status[i]));
+            std::memcpy(&out[i * 21 + 1], addresses[i].data(), 20);
+            if (malformed) {
+                std::memset(&out[i * 21 + 1], 0, 20);
+            }
+        }
+    } else {
+        std::vector<eth::AddressString> text(count);
+        eth::formatAddresses(addresses, text);
+        out.reserve(count * 43);
+        for (size_t i = 0; i < count; ++i) {
+            if (wellFormed && !wellFormed[i]) {
+                out.append("error malformed-record\n");
+            } else if (status[i] != eth::RecoverStatus::Ok) {
+                out.append("error ").append(eth::recoverStatusName(status[i])).push_back('\n');
+            } else {
+                out.append(text[i].data(), 42).push_back('\n');
+            }
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        totals.failed += (wellFormed && !wellFormed[i]) || status[i] != eth::RecoverStatus::Ok;
+    }
+    totals.records += count;
+    return writeAll(STDOUT_FILENO, out.data(), out.size());
+}
+
+static bool recoverBinary(int fd, bool rawOutput, RecoverTotals& totals) {
+    std::vector<eth::RecoverRecord> records(RECOVER_BATCH);
+    while (true) {
+        const long long bytes = readFull(fd, records.data(), records.size() * sizeof(eth::RecoverRecord));
+        if (bytes < 0) {
+            std::cerr << "Error: read failed: " << std::strerror(errno) << '\n';
+            return false;
+        }
+        const size_t count = static_cast<size_t>(bytes) / sizeof(eth::RecoverRecord);
+        if (count > 0 && !recoverBatch(records, count, nullptr, rawOutput, totals)) {
+            return false;
+        }
+        if (count < records.size()) {
+            if (bytes % sizeof(eth::RecoverRecord) != 0) {
+                std::cerr << "Warning: ignoring " << bytes % sizeof(eth::RecoverRecord)
+                          << " trailing bytes (incomplete record)\n";
+            }
+            return true;
+        }
+    }
+}
+
+static bool recoverHexLines(std::istream& in, bool rawOutput, RecoverTotals& totals) {
+    std::vector<eth::RecoverRecord> records(RECOVER_BATCH);
+    std::vector<uint8_t> wellFormed(RECOVER_BATCH);
+    std::string line;
+    size_t count = 0;
+    while (std::getline(in, line)) {
+        wellFormed[count] = parseRecordLine(line, records[count]);
+        if (!wellFormed[count]) {
+            records[count] = {};
+        }
+        if (++count == RECOVER_BATCH) {
+            if (!recoverBatch(records, count, wellFormed.data(), rawOutput, totals)) {
+                return false;
+            }
+            count = 0;
+        }
+    }
+    return count == 0 || recoverBatch(records, count, wellFormed.data(), rawOutput, totals);
+}
+
+int main(int argc, char* argv[]) {
+    bool hexInput = false;
+    bool rawOutput = false;
+    std::string path = "-";
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--hex") {
+            hexInput = true;
+        } else if (arg == "--raw") {
+            rawOutput = true;
+        } else if (arg.starts_with("--")) {
+            // Never treat a mistyped or misplaced option as a file name.
+            std::cerr << "Error: unknown option: " << arg << '\n';
+            return 1;
+        } else {
+            path = arg;
+        }
+    }
+    const bool isStdin = (path == "-");
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        RecoverTotals totals;
+        bool ok;
+        if (hexInput) {
+            std::ios::sync_with_stdio(false);
+            std::ifstream file;
+            if (!isStdin) {
+                file.open(path, std::ios::binary);
+                if (!file) {
+                    std::cerr << "Error: cannot open " << path << '\n';
+                    return 1;
+                }
+            }
+            ok = recoverHexLines(isStdin ? std::cin : file, rawOutput, totals);
+        } else {
+            int fd = isStdin ? STDIN_FILENO : open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                std::cerr << "Error: cannot open " << path << ": " << std::strerror(errno) << '\n';
+                return 1;
+            }
+            ok = recoverBinary(fd, rawOutput, totals);
+            if (!isStdin) {
+                close(fd);
+            }
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << path << ": " << totals.records << " records in " << seconds << " s";
+        if (seconds > 0) {
+            std::cerr << " (" << static_cast<size_t>(static_cast<double>(totals.records) / seconds) << " records/s)";
+        }
+        if (totals.failed > 0) {
+            std::cerr << ", " << totals.failed << " not recovered";
+        }
+        std::cerr << '\n';
+        if (!ok) {
+            std::cerr << "Error: I/O failure\n";
+            return 1;
+        }
+        return totals.failed == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+}
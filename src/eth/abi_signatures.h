@@ -0,0 +1,113 @@
+// abi_signatures.h - Compile-time function selectors and event topics
+//
+//   using namespace eth::literals;
+//   switch (eth::selectorOf(calldata)) {
+//       case "transfer(address,uint256)"_selector: ...
+//   }
+//   switch (eth::topicPrefixOf(log.topics[0])) {
+//       case "Transfer(address,address,uint256)"_topic_prefix: ...  // then compare the full topic
+//   }
+//
+// Signatures are hashed while compiling (the helpers are consteval), so none of
+// these digests is computed at run time.
+#ifndef ETH_ABI_SIGNATURES_H
+#define ETH_ABI_SIGNATURES_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <string_view>
+
+#include "../keccak/keccak_constexpr.h"
+
+namespace eth {
+
+    using Byte = unsigned char;
+
+    // keccak256 of an event signature: topic 0 of the log it emits.
+    using Topic = std::array<Byte, 32>;
+
+    // First four bytes of keccak256 of a function signature.
+    using SelectorBytes = std::array<Byte, 4>;
+
+    /**
+     * @brief Function selector of a canonical signature, as a big-endian integer.
+     * @param signature e.g. "transfer(address,uint256)" (no spaces, no parameter names).
+     * @note The integer form is what selectorOf() returns, so it works as a case label.
+     */
+    consteval uint32_t selector(std::string_view signature) {
+        const auto digest = keccak256Constexpr(signature);
+        return (uint32_t(digest[0]) << 24) | (uint32_t(digest[1]) << 16) | (uint32_t(digest[2]) << 8) | digest[3];
+    }
+
+    /**
+     * @brief Function selector of a canonical signature, as the four bytes found in calldata.
+     */
+    consteval SelectorBytes selectorBytes(std::string_view signature) {
+        const auto digest = keccak256Constexpr(signature);
+        return { digest[0], digest[1], digest[2], digest[3] };
+    }
+
+    /**
+     * @brief Event topic of a canonical signature, e.g. "Transfer(address,address,uint256)".
+     */
+    consteval Topic topic(std::string_view signature) {
+        const auto digest = keccak256Constexpr(signature);
+        Topic out{};
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = digest[i];
+        }
+        return out;
+    }
+
+    /**
+     * @brief Leading eight bytes of an event topic as a big-endian integer.
+     * @note A 32-byte topic cannot be a case label; switch on this prefix (see topicPrefixOf)
+     *       and confirm the match against topic() when the input is untrusted.
+     */
+    consteval uint64_t topicPrefix(std::string_view signature) {
+        const auto digest = keccak256Constexpr(signature);
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            prefix = (prefix << 8) | digest[i];
+        }
+        return prefix;
+    }
+
+    /**
+     * @brief Selector at the start of calldata (at least four bytes), comparable with selector().
+     */
+    inline uint32_t selectorOf(const Byte* calldata) noexcept {
+        return (uint32_t(calldata[0]) << 24) | (uint32_t(calldata[1]) << 16) | (uint32_t(calldata[2]) << 8) | calldata[3];
+    }
+
+    /**
+     * @brief Leading eight bytes of a 32-byte topic, comparable with topicPrefix().
+     */
+    inline uint64_t topicPrefixOf(const Byte* topic) noexcept {
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            prefix = (prefix << 8) | topic[i];
+        }
+        return prefix;
+    }
+
+    namespace literals {
+
+        consteval uint32_t operator""_selector(const char* signature, size_t length) {
+            return selector(std::string_view(signature, length));
+        }
+
+        consteval Topic operator""_topic(const char* signature, size_t length) {
+            return topic(std::string_view(signature, length));
+        }
+
+        consteval uint64_t operator""_topic_prefix(const char* signature, size_t length) {
+            return topicPrefix(std::string_view(signature, length));
+        }
+
+    } // namespace literals
+
+} // namespace eth
+
+#endif // ETH_ABI_SIGNATURES_H
@@ -0,0 +1,161 @@
+// address.h - 20-byte Ethereum address value type with on-demand hex / EIP-55 formatting
+#ifndef ETH_ADDRESS_H
+#define ETH_ADDRESS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <version>
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+#include "../keccak/keccak.h"
+#include "eip55.h"
+#include "hex.h"
+
+namespace eth {
+
+    using Byte = unsigned char;
+
+    /**
+     * @brief A raw Ethereum address held by value.
+     *
+     * Exactly 20 trivially copyable bytes: arrays of Address share the layout of the
+     * packed 20-byte outputs of the batch API, and addresses can be compared, sorted
+     * (byte order, i.e. numeric order) and hashed without producing any text. Text is
+     * only produced on request; the checksum's extra Keccak-256 is paid only by the
+     * checksummed forms, never by comparison, hashing or lowercase hex.
+     */
+    struct Address {
+        static constexpr size_t SIZE = 20;
+
+        std::array<Byte, SIZE> bytes{};
+
+        // Copy 20 address bytes.
+        static Address fromBytes(const Byte* data) noexcept {
+            Address address;
+            std::memcpy(address.bytes.data(), data, SIZE);
+            return address;
+        }
+
+        /**
+         * @brief Parse 40 hex digits, optionally prefixed with "0x" or "0X".
+         * @return false if the text is not exactly one well-formed address.
+         * @note Any letter case is accepted; use verifyEIP55 to check a checksum.
+         */
+        static bool parse(std::string_view text, Address& out) noexcept {
+            if (text.size() == 42 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+                text.remove_prefix(2);
+            }
+            return text.size() == 2 * SIZE && hexDecode(text.data(), text.size(), out.bytes.data());
+        }
+
+        const Byte* data() const noexcept { return bytes.data(); }
+        Byte* data() noexcept { return bytes.data(); }
+        static constexpr size_t size() noexcept { return SIZE; }
+
+        bool isZero() const noexcept { return *this == Address{}; }
+
+        // Write "0x" and 40 lowercase hex digits, NUL-terminated (43 bytes).
+        void toHex(char* buffer) const noexcept {
+            buffer[0] = '0';
+            buffer[1] = 'x';
+            encodeEIP55Hex(bytes.data(), nullptr, buffer + 2);
+            buffer[42] = '\0';
+        }
+
+        // Write the "0x"-prefixed EIP-55 checksummed form, NUL-terminated (43 bytes).
+        void toChecksumHex(char* buffer) const noexcept { toEIP55(bytes.data(), buffer); }
+
+        std::array<char, 43> lowercase() const noexcept {
+            std::array<char, 43> text;
+            toHex(text.data());
+            return text;
+        }
+
+        std::array<char, 43> checksummed() const noexcept {
+            std::array<char, 43> text;
+            toChecksumHex(text.data());
+            return text;
+        }
+
+        std::string toString(bool checksum = true) const {
+            const std::array<char, 43> text = checksum ? checksummed() : lowercase();
+            return std::string(text.data(), 42);
+        }
+
+        friend bool operator==(const Address& a, const Address& b) noexcept {
+            return std::memcmp(a.bytes.data(), b.bytes.data(), SIZE) == 0;
+        }
+
+        friend std::strong_ordering operator<=>(const Address& a, const Address& b) noexcept {
+            return std::memcmp(a.bytes.data(), b.bytes.data(), SIZE) <=> 0;
+        }
+    };
+
+    static_assert(sizeof(Address) == 20 && alignof(Address) == 1, "Address must be 20 packed bytes");
+    static_assert(std::is_trivially_copyable_v<Address>, "Address must be trivially copyable");
+
+    /**
+     * @brief Hash for unordered containers.
+     * @note Addresses are Keccak output, but vanity addresses share long zero prefixes,
+     *       so both ends of the address are mixed in.
+     */
+    struct AddressHash {
+        size_t operator()(const Address& address) const noexcept {
+            uint64_t head;
+            uint64_t tail;
+            std::memcpy(&head, address.bytes.data(), 8);
+            std::memcpy(&tail, address.bytes.data() + 12, 8);
+            uint64_t h = (head ^ (tail * 0x9E3779B97F4A7C15ULL)) * 0xC2B2AE3D27D4EB4FULL;
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    };
+
+    // Streams the EIP-55 checksummed form.
+    inline std::ostream& operator<<(std::ostream& out, const Address& address) {
+        const std::array<char, 43> text = address.checksummed();
+        return out.write(text.data(), 42);
+    }
+
+} // namespace eth
+
+template <>
+struct std::hash<eth::Address> : eth::AddressHash {};
+
+#if defined(__cpp_lib_format)
+// "{}" formats the EIP-55 checksummed address, "{:x}" plain lowercase hex; both "0x"-prefixed.
+template <>
+struct std::formatter<eth::Address, char> {
+    bool lowercase = false;
+
+    constexpr auto parse(std::format_parse_context& ctx) {
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it == 'x') {
+            lowercase = true;
+            ++it;
+        }
+        if (it != ctx.end() && *it != '}') {
+            throw std::format_error("invalid format for eth::Address");
+        }
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const eth::Address& address, FormatContext& ctx) const {
+        const std::array<char, 43> text = lowercase ? address.lowercase() : address.checksummed();
+        return std::copy_n(text.data(), 42, ctx.out());
+    }
+};
+#endif
+
+#endif // ETH_ADDRESS_H
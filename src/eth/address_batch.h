@@ -0,0 +1,346 @@
+// address_batch.h - Contiguous batch derivation of raw Ethereum addresses from public keys
+#ifndef ETH_ADDRESS_BATCH_H
+#define ETH_ADDRESS_BATCH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+
+#include "../keccak/keccak.h"
+#include "../keccak/keccak_multibuffer.h"
+#include "address.h"
+#include "address_cache.h"
+#include "eip55.h"
+#include "../metrics/metrics.h"
+#include "thread_pool.h"
+
+namespace eth {
+
+    using Byte = unsigned char;
+
+    // Uncompressed secp256k1 public key without the 0x04 prefix (X || Y).
+    using PublicKeyBytes = std::array<Byte, 64>;
+    // Raw Ethereum address: the last 20 bytes of Keccak-256(X || Y).
+    using AddressBytes = std::array<Byte, 20>;
+    // "0x"-prefixed, NUL-terminated address text.
+    using AddressString = std::array<char, 43>;
+
+    static_assert(sizeof(PublicKeyBytes) == 64 && sizeof(AddressBytes) == 20,
+                  "key and address arrays must be tightly packed");
+
+    /**
+     * @brief Derive the address of one 64-byte public key (X || Y).
+     * @note One Keccak-256 of the key; no text and no checksum hash.
+     */
+    inline Address deriveAddress(const Byte* publicKey) noexcept {
+        std::array<Byte, Keccak256::DIGESTSIZE> hash;
+        {
+            metrics::StageTimer timer(metrics::Stage::PublicKeyHash);
+            keccak256Fixed<64>(publicKey, hash.data());
+        }
+        return Address::fromBytes(hash.data() + 12);
+    }
+
+    inline Address deriveAddress(const PublicKeyBytes& publicKey) noexcept {
+        return deriveAddress(publicKey.data());
+    }
+
+    namespace address_detail {
+
+        // Keys hashed per multi-buffer call; matches the widest (8-way AVX-512) kernel.
+        inline constexpr size_t CHUNK_SIZE = 8;
+
+        // Addresses handed to a worker at a time: 64 * 20 bytes = 20 cache lines of output.
+        inline constexpr size_t GRAIN = 64;
+
+        /**
+         * @brief Hash up to CHUNK_SIZE 64-byte keys and write their 20-byte addresses.
+         * @param keys `count` pointers to 64-byte public keys.
+         * @param count Number of keys (at most CHUNK_SIZE).
+         * @param addresses Destination for `count` packed 20-byte addresses.
+         */
+        inline void hashKeyChunk(const Byte* const* keys, size_t count, Byte* addresses) noexcept {
+            metrics::StageTimer timer(metrics::Stage::BatchKeyHash, count);
+            std::array<std::array<Byte, Keccak256::DIGESTSIZE>, CHUNK_SIZE> hashes;
+            Byte* digests[CHUNK_SIZE];
+            for (size_t k = 0; k < CHUNK_SIZE; ++k) {
+                digests[k] = hashes[k].data();
+            }
+            keccak256MultiBuffer(keys, 64, digests, count);
+            for (size_t k = 0; k < count; ++k) {
+                std::memcpy(addresses + 20 * k, hashes[k].data() + 12, 20);
+            }
+        }
+
+        /**
+         * @brief Derive addresses for records [begin, end) of a strided key buffer on the calling thread.
+         * @note Each record's key is its last 64 bytes (see deriveAddresses).
+         */
+        inline void deriveRange(const Byte* records, size_t stride, Byte* addresses,
+                                size_t begin, size_t end) noexcept {
+            const Byte* keys[CHUNK_SIZE];
+            const size_t keyOffset = stride - 64;
+            for (size_t first = begin; first < end; first += CHUNK_SIZE) {
+                const size_t count = std::min(CHUNK_SIZE, end - first);
+                for (size_t k = 0; k < count; ++k) {
+                    keys[k] = records + (first + k) * stride + keyOffset;
+                }
+                hashKeyChunk(keys, count, addresses + 20 * first);
+            }
+        }
+
+        /**
+         * @brief Derive up to CHUNK_SIZE keys, consulting and filling a cache.
+         * @param keys `count` pointers to 64-byte public keys.
+         * @param addresses Destination for `count` packed 20-byte addresses.
+         * @param text If non-null, destination for `count` EIP-55 strings (cached with the address).
+         * @param valid If non-null, keys with a zero flag are neither looked up, hashed nor cached;
+         *        their address (and text) is zeroed.
+         * @note Only the misses are hashed, still as one multi-buffer call.
+         */
+        inline void deriveChunkCached(const Byte* const* keys, size_t count, Byte* addresses,
+                                      std::array<char, 43>* text, AddressCache& cache,
+                                      const uint8_t* valid = nullptr) noexcept {
+            const Byte* missKeys[CHUNK_SIZE];
+            size_t missIndex[CHUNK_SIZE];
+            size_t misses = 0;
+            for (size_t k = 0; k < count; ++k) {
+                if (valid && !valid[k]) {
+                    std::memset(addresses + 20 * k, 0, 20);
+                    if (text) {
+                        text[k] = {};
+                    }
+                    continue;
+                }
+                if (!cache.lookup(keys[k], addresses + 20 * k, text ? text[k].data() : nullptr)) {
+                    missKeys[misses] = keys[k];
+                    missIndex[misses++] = k;
+                }
+            }
+            if (misses == 0) {
+                return;
+            }
+            Byte raw[CHUNK_SIZE * 20];
+            std::array<char, 43> formatted[CHUNK_SIZE];
+            hashKeyChunk(missKeys, misses, raw);
+            if (text) {
+                toEIP55Batch(raw, misses, formatted);
+            }
+            for (size_t m = 0; m < misses; ++m) {
+                const size_t k = missIndex[m];
+                std::memcpy(addresses + 20 * k, raw + 20 * m, 20);
+                if (text) {
+                    text[k] = formatted[m];
+                }
+                cache.insert(missKeys[m], raw + 20 * m, text ? formatted[m].data() : nullptr);
+            }
+        }
+
+        // deriveRange through a cache; `text` and `valid` may be nullptr.
+        inline void deriveRangeCached(const Byte* records, size_t stride, Byte* addresses,
+                                      std::array<char, 43>* text, AddressCache& cache,
+                                      const uint8_t* valid, size_t begin, size_t end) noexcept {
+            const Byte* keys[CHUNK_SIZE];
+            const size_t keyOffset = stride - 64;
+            for (size_t first = begin; first < end; first += CHUNK_SIZE) {
+                const size_t count = std::min(CHUNK_SIZE, end - first);
+                for (size_t k = 0; k < count; ++k) {
+                    keys[k] = records + (first + k) * stride + keyOffset;
+                }
+                deriveChunkCached(keys, count, addresses + 20 * first, text ? text + first : nullptr, cache,
+                                  valid ? valid + first : nullptr);
+            }
+        }
+
+    } // namespace address_detail
+
+    /**
+     * @brief Derive raw addresses from a packed buffer of public-key records.
+     * @param records First record; record i starts at records + i * stride.
+     * @param stride Bytes per record (at least 64). The key is the last 64 bytes of each record,
+     *        so 65-byte records carrying the 0x04 uncompressed-point prefix work unchanged.
+     * @param count Number of records.
+     * @param addresses Destination for `count` packed 20-byte addresses.
+     * @param pool Pool whose workers run the derivation.
+     * @throws std::invalid_argument if stride is less than 64.
+     * @note The input is only read, so it may be a read-only memory mapping of a key dump.
+     *       No memory is allocated per key.
+     */
+    inline void deriveAddresses(const Byte* records, size_t stride, size_t count, Byte* addresses,
+                                ThreadPool& pool) {
+        if (stride < 64) {
+            throw std::invalid_argument("Public key record stride must be at least 64 bytes.");
+        }
+        pool.parallelFor(count, address_detail::GRAIN, [&](size_t begin, size_t end) {
+            address_detail::deriveRange(records, stride, addresses, begin, end);
+        });
+    }
+
+    /**
+     * @brief Derive raw addresses from a packed buffer of public-key records on the shared pool.
+     * @throws std::invalid_argument if stride is less than 64.
+     */
+    inline void deriveAddresses(const Byte* records, size_t stride, size_t count, Byte* addresses) {
+        deriveAddresses(records, stride, count, addresses, ThreadPool::shared());
+    }
+
+    /**
+     * @brief Derive raw addresses from a packed buffer of public-key records through a cache.
+     * @param cache Results for repeated keys are copied from here; new results are added.
+     * @param valid If non-null, one flag per record; records flagged 0 bypass the cache and
+     *        get a zero address, so malformed input never displaces real entries.
+     * @throws std::invalid_argument if stride is less than 64.
+     * @note Same record layout as the uncached overload.
+     */
+    inline void deriveAddresses(const Byte* records, size_t stride, size_t count, Byte* addresses,
+                                AddressCache& cache, ThreadPool& pool, const uint8_t* valid = nullptr) {
+        if (stride < 64) {
+            throw std::invalid_argument("Public key record stride must be at least 64 bytes.");
+        }
+        pool.parallelFor(count, address_detail::GRAIN, [&](size_t begin, size_t end) {
+            address_detail::deriveRangeCached(records, stride, addresses, nullptr, cache, valid, begin, end);
+        });
+    }
+
+    /**
+     * @brief Derive raw and EIP-55 addresses together through a cache.
+     * @param addresses Destination for `count` packed 20-byte addresses.
+     * @param text Destination for `count` "0x"-prefixed, NUL-terminated EIP-55 strings.
+     * @param valid As for the cached deriveAddresses; invalid records get an empty string.
+     * @throws std::invalid_argument if stride is less than 64.
+     * @note A hit skips both the address hash and the checksum hash.
+     */
+    inline void deriveChecksummedAddresses(const Byte* records, size_t stride, size_t count, Byte* addresses,
+                                           std::array<char, 43>* text, AddressCache& cache, ThreadPool& pool,
+                                           const uint8_t* valid = nullptr) {
+        if (stride < 64) {
+            throw std::invalid_argument("Public key record stride must be at least 64 bytes.");
+        }
+        pool.parallelFor(count, address_detail::GRAIN, [&](size_t begin, size_t end) {
+            address_detail::deriveRangeCached(records, stride, addresses, text, cache, valid, begin, end);
+        });
+    }
+
+    /**
+     * @brief Derive raw addresses from contiguous 64-byte public keys.
+     * @param publicKeys Keys, packed back to back.
+     * @param addresses One output per key.
+     * @param pool Pool whose workers run the derivation.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline void deriveAddresses(std::span<const PublicKeyBytes> publicKeys, std::span<AddressBytes> addresses,
+                                ThreadPool& pool) {
+        if (publicKeys.size() != addresses.size()) {
+            throw std::invalid_argument("Number of public keys and addresses must match.");
+        }
+        deriveAddresses(reinterpret_cast<const Byte*>(publicKeys.data()), sizeof(PublicKeyBytes), publicKeys.size(),
+                        reinterpret_cast<Byte*>(addresses.data()), pool);
+    }
+
+    /**
+     * @brief Derive raw addresses from contiguous 64-byte public keys on the shared pool.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline void deriveAddresses(std::span<const PublicKeyBytes> publicKeys, std::span<AddressBytes> addresses) {
+        deriveAddresses(publicKeys, addresses, ThreadPool::shared());
+    }
+
+    /**
+     * @brief Derive addresses from contiguous 64-byte public keys into Address values.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline void deriveAddresses(std::span<const PublicKeyBytes> publicKeys, std::span<Address> addresses,
+                                ThreadPool& pool) {
+        if (publicKeys.size() != addresses.size()) {
+            throw std::invalid_argument("Number of public keys and addresses must match.");
+        }
+        deriveAddresses(reinterpret_cast<const Byte*>(publicKeys.data()), sizeof(PublicKeyBytes), publicKeys.size(),
+                        reinterpret_cast<Byte*>(addresses.data()), pool);
+    }
+
+    /**
+     * @brief Derive addresses from contiguous 64-byte public keys into Address values on the shared pool.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline void deriveAddresses(std::span<const PublicKeyBytes> publicKeys, std::span<Address> addresses) {
+        deriveAddresses(publicKeys, addresses, ThreadPool::shared());
+    }
+
+    namespace address_detail {
+
+        // Format `count` packed 20-byte addresses into 43-byte buffers on the pool.
+        inline void formatPacked(const Byte* addresses, size_t count, AddressString* out, bool checksum,
+                                 ThreadPool& pool) {
+            pool.parallelFor(count, GRAIN, [&](size_t begin, size_t end) {
+                const Byte* raw = addresses + 20 * begin;
+                if (checksum) {
+                    toEIP55Batch(raw, end - begin, out + begin);
+                    return;
+                }
+                for (size_t i = begin; i < end; ++i, raw += 20) {
+                    char* buffer = out[i].data();
+                    buffer[0] = '0';
+                    buffer[1] = 'x';
+                    encodeEIP55Hex(raw, nullptr, buffer + 2);
+                    buffer[42] = '\0';
+                }
+            });
+        }
+
+    } // namespace address_detail
+
+    /**
+     * @brief Optional formatting stage: render raw addresses as "0x"-prefixed text.
+     * @param addresses Raw addresses.
+     * @param out One 43-byte buffer per address (NUL-terminated on return).
+     * @param checksum Apply EIP-55 casing (true) or emit plain lowercase hex (false).
+     * @param pool Pool whose workers run the formatting.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline void formatAddresses(std::span<const AddressBytes> addresses, std::span<AddressString> out,
+                                bool checksum, ThreadPool& pool) {
+        if (addresses.size() != out.size()) {
+            throw std::invalid_argument("Number of addresses and output buffers must match.");
+        }
+        address_detail::formatPacked(reinterpret_cast<const Byte*>(addresses.data()), addresses.size(), out.data(),
+                                     checksum, pool);
+    }
+
+    /**
+     * @brief Optional formatting stage on the shared pool.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline void formatAddresses(std::span<const AddressBytes> addresses, std::span<AddressString> out,
+                                bool checksum = true) {
+        formatAddresses(addresses, out, checksum, ThreadPool::shared());
+    }
+
+    /**
+     * @brief Optional formatting stage for Address values.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline void formatAddresses(std::span<const Address> addresses, std::span<AddressString> out,
+                                bool checksum, ThreadPool& pool) {
+        if (addresses.size() != out.size()) {
+            throw std::invalid_argument("Number of addresses and output buffers must match.");
+        }
+        address_detail::formatPacked(reinterpret_cast<const Byte*>(addresses.data()), addresses.size(), out.data(),
+                                     checksum, pool);
+    }
+
+    /**
+     * @brief Optional formatting stage for Address values on the shared pool.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline void formatAddresses(std::span<const Address> addresses, std::span<AddressString> out,
+                                bool checksum = true) {
+        formatAddresses(addresses, out, checksum, ThreadPool::shared());
+    }
+
+} // namespace eth
+
+#endif // ETH_ADDRESS_BATCH_H
@@ -0,0 +1,233 @@
+// address_batcher.h - Asynchronous micro-batching front end for address derivation
+#ifndef ETH_ADDRESS_BATCHER_H
+#define ETH_ADDRESS_BATCHER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "address.h"
+#include "address_batch.h"
+#include "address_cache.h"
+#include "thread_pool.h"
+
+namespace eth {
+
+    // Result of one derivation: the raw address and its EIP-55 text.
+    struct DerivedAddress {
+        Address address;
+        AddressString text;
+    };
+
+    /**
+     * @brief Gathers single derivation requests from many threads into batches.
+     *
+     * submit() only queues the key. A dispatcher thread waits until either
+     * `maxBatch` requests are queued or the oldest request has waited `maxWait`,
+     * then derives the whole batch through the multi-buffer batch path (on the
+     * pool when the batch is large enough) and completes each request's future or
+     * callback. Under load the batches fill long before the deadline, so callers
+     * gain the batch throughput; under light load a request waits at most about
+     * `maxWait` longer than a direct call.
+     */
+    class AddressBatcher {
+    public:
+        // Receives the result, or a zeroed result and the exception if the batch failed.
+        using Callback = std::function<void(const DerivedAddress&, std::exception_ptr)>;
+
+        struct Options {
+            size_t maxBatch = 256;                        // requests per dispatched batch
+            std::chrono::microseconds maxWait{50};        // longest a request waits for company
+            ThreadPool* pool = nullptr;                   // nullptr = ThreadPool::shared()
+            AddressCache* cache = nullptr;                // optional; consulted for every key
+        };
+
+        // Counters since construction, for tuning maxBatch and maxWait.
+        struct Stats {
+            uint64_t requests = 0;
+            uint64_t batches = 0;
+            uint64_t fullBatches = 0; // dispatched because maxBatch was reached
+            uint64_t largestBatch = 0;
+        };
+
+        AddressBatcher() : AddressBatcher(Options{}) {}
+
+        /**
+         * @throws std::invalid_argument if maxBatch is zero.
+         */
+        explicit AddressBatcher(Options options) : options_(options) {
+            if (options_.maxBatch == 0) {
+                throw std::invalid_argument("AddressBatcher maxBatch must be non-zero.");
+            }
+            if (!options_.pool) {
+                options_.pool = &ThreadPool::shared();
+            }
+            dispatcher_ = std::thread([this] { dispatchLoop(); });
+        }
+
+        // Completes every queued request, then stops the dispatcher.
+        ~AddressBatcher() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            dispatcher_.join();
+        }
+
+        AddressBatcher(const AddressBatcher&) = delete;
+        AddressBatcher& operator=(const AddressBatcher&) = delete;
+
+        /**
+         * @brief Queue one key; the future becomes ready when its batch has been derived.
+         * @param publicKey 64-byte public key (X || Y).
+         */
+        std::future<DerivedAddress> submit(const PublicKeyBytes& publicKey) {
+            Request request{ publicKey, std::promise<DerivedAddress>{} };
+            std::future<DerivedAddress> result = std::get<std::promise<DerivedAddress>>(request.completion).get_future();
+            enqueue(std::move(request));
+            return result;
+        }
+
+        /**
+         * @brief Queue one key; `callback` runs on the dispatcher thread when its batch is done.
+         * @note Callbacks delay the rest of their batch, so they should only hand the result on.
+         *       An exception thrown by a callback is swallowed.
+         */
+        void submit(const PublicKeyBytes& publicKey, Callback callback) {
+            enqueue(Request{ publicKey, std::move(callback) });
+        }
+
+        Stats stats() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_;
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Request {
+            PublicKeyBytes key;
+            std::variant<std::promise<DerivedAddress>, Callback> completion;
+        };
+
+        void enqueue(Request request) {
+            bool notify;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stopping_) {
+                    throw std::runtime_error("AddressBatcher is shutting down.");
+                }
+                if (pending_.empty()) {
+                    oldest_ = Clock::now();
+                }
+                pending_.push_back(std::move(request));
+                ++stats_.requests;
+                // The dispatcher only needs waking to start the deadline or when a batch is full.
+                notify = pending_.size() == 1 || pending_.size() == options_.maxBatch;
+            }
+            if (notify) {
+                wake_.notify_one();
+            }
+        }
+
+        void dispatchLoop() {
+            std::vector<Request> batch;
+            batch.reserve(options_.maxBatch);
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                wake_.wait(lock, [&] { return stopping_ || !pending_.empty(); });
+                if (pending_.empty()) {
+                    return; // stopping and drained
+                }
+                wake_.wait_until(lock, oldest_ + options_.maxWait,
+                                 [&] { return stopping_ || pending_.size() >= options_.maxBatch; });
+
+                const size_t take = std::min(pending_.size(), options_.maxBatch);
+                for (size_t i = 0; i < take; ++i) {
+                    batch.push_back(std::move(pending_.front()));
+                    pending_.pop_front();
+                }
+                if (!pending_.empty()) {
+                    // The leftovers have waited at least as long as this batch.
+                    oldest_ = Clock::now() - options_.maxWait;
+                }
+                ++stats_.batches;
+                stats_.fullBatches += take == options_.maxBatch;
+                stats_.largestBatch = std::max<uint64_t>(stats_.largestBatch, take);
+
+                lock.unlock();
+                process(batch);
+                batch.clear();
+                lock.lock();
+            }
+        }
+
+        void process(std::vector<Request>& batch) {
+            const size_t count = batch.size();
+            std::exception_ptr error;
+            try {
+                keys_.resize(count);
+                addresses_.resize(count);
+                text_.resize(count);
+                for (size_t i = 0; i < count; ++i) {
+                    keys_[i] = batch[i].key;
+                }
+                const Byte* records = keys_.data()->data();
+                if (options_.cache) {
+                    deriveChecksummedAddresses(records, sizeof(PublicKeyBytes), count, addresses_.data()->data(),
+                                               text_.data(), *options_.cache, *options_.pool);
+                } else {
+                    deriveAddresses(records, sizeof(PublicKeyBytes), count, addresses_.data()->data(),
+                                    *options_.pool);
+                    formatAddresses(addresses_, text_, true, *options_.pool);
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+            for (size_t i = 0; i < count; ++i) {
+                const DerivedAddress result = error ? DerivedAddress{} : DerivedAddress{ addresses_[i], text_[i] };
+                if (auto* callback = std::get_if<Callback>(&batch[i].completion)) {
+                    try {
+                        (*callback)(result, error);
+                    } catch (...) {
+                    }
+                } else if (error) {
+                    std::get<std::promise<DerivedAddress>>(batch[i].completion).set_exception(error);
+                } else {
+                    std::get<std::promise<DerivedAddress>>(batch[i].completion).set_value(result);
+                }
+            }
+        }
+
+        Options options_;
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+        std::deque<Request> pending_;
+        Clock::time_point oldest_{};
+        bool stopping_ = false;
+        Stats stats_;
+
+        // Dispatcher-only scratch, reused across batches.
+        std::vector<PublicKeyBytes> keys_;
+        std::vector<Address> addresses_;
+        std::vector<AddressString> text_;
+
+        std::thread dispatcher_;
+    };
+
+} // namespace eth
+
+#endif // ETH_ADDRESS_BATCHER_H
@@ -0,0 +1,249 @@
+// address_cache.h - Bounded concurrent cache of public-key -> address results
+#ifndef ETH_ADDRESS_CACHE_H
+#define ETH_ADDRESS_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#include "../keccak/keccak.h"
+
+namespace eth {
+
+    using Byte = unsigned char;
+
+    // Counters accumulated since construction (or the last resetStats()).
+    struct AddressCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+
+        double hitRate() const noexcept {
+            const uint64_t lookups = hits + misses;
+            return lookups ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+        }
+    };
+
+    /**
+     * @brief Fixed-capacity, thread-safe map from 64-byte public keys to their addresses.
+     *
+     * The cache is split into independently locked shards; each shard is an array of
+     * 8-way sets. A key hashes to one shard and one set, so a lookup compares eight
+     * 32-bit tags and at most a couple of full keys. Full sets evict with CLOCK: every
+     * hit sets the entry's referenced bit and the set's hand skips (and clears)
+     * referenced entries, an approximation of LRU that needs no list maintenance.
+     *
+     * Entries are fixed 128-byte records holding the key, the raw address and,
+     * optionally, the 40 EIP-55 hex digits, so a repeated key skips both the address
+     * hash and the checksum hash. Nothing is allocated after construction.
+     */
+    class AddressCache {
+    public:
+        static constexpr size_t WAYS = 8;
+        static constexpr size_t DEFAULT_SHARDS = 64;
+
+        /**
+         * @param capacity Approximate number of entries (rounded up to fill whole sets).
+         * @param shards Number of independently locked shards; rounded up to a power of two
+         *        and reduced for caches too small to give each shard a set.
+         * @throws std::invalid_argument if capacity or shards is zero.
+         */
+        explicit AddressCache(size_t capacity, size_t shards = DEFAULT_SHARDS) {
+            if (capacity == 0 || shards == 0) {
+                throw std::invalid_argument("Address cache capacity and shard count must be non-zero.");
+            }
+            // Small caches use fewer shards so every shard still holds at least one set.
+            shardCount_ = std::min(std::bit_ceil(shards), std::bit_floor(std::max<size_t>(1, capacity / WAYS)));
+            const size_t setsPerShard = (capacity + WAYS * shardCount_ - 1) / (WAYS * shardCount_);
+            setsPerShard_ = std::bit_ceil(setsPerShard);
+            shardBits_ = static_cast<unsigned>(std::countr_zero(shardCount_));
+            shards_ = std::make_unique<Shard[]>(shardCount_);
+            for (size_t s = 0; s < shardCount_; ++s) {
+                shards_[s].sets = std::make_unique<Set[]>(setsPerShard_);
+                shards_[s].entries = std::make_unique<Entry[]>(setsPerShard_ * WAYS);
+            }
+        }
+
+        AddressCache(const AddressCache&) = delete;
+        AddressCache& operator=(const AddressCache&) = delete;
+
+        // Total number of entries the cache can hold.
+        size_t capacity() const noexcept { return shardCount_ * setsPerShard_ * WAYS; }
+
+        /**
+         * @brief Look up a key.
+         * @param key 64-byte public key (X || Y).
+         * @param address Receives the 20-byte address on a hit.
+         * @param text If non-null, receives the "0x"-prefixed, NUL-terminated EIP-55 address
+         *        (43 bytes) on a hit. An entry stored without its text counts as a miss here.
+         * @return Whether everything requested was found.
+         */
+        bool lookup(const Byte* key, Byte* address, char* text = nullptr) noexcept {
+            const uint64_t h = hashKey(key);
+            Shard& shard = shardFor(h);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            const size_t setIndex = setFor(h);
+            const int way = find(shard, setIndex, tagFor(h), key);
+            if (way < 0) {
+                ++shard.stats.misses;
+                return false;
+            }
+            const Entry& entry = shard.entries[setIndex * WAYS + static_cast<size_t>(way)];
+            if (text && !entry.hasText) {
+                ++shard.stats.misses;
+                return false;
+            }
+            shard.sets[setIndex].referenced |= static_cast<uint8_t>(1u << way);
+            std::memcpy(address, entry.address, sizeof(entry.address));
+            if (text) {
+                text[0] = '0';
+                text[1] = 'x';
+                std::memcpy(text + 2, entry.text, sizeof(entry.text));
+                text[42] = '\0';
+            }
+            ++shard.stats.hits;
+            return true;
+        }
+
+        /**
+         * @brief Store (or update) the result for a key, evicting with CLOCK if its set is full.
+         * @param key 64-byte public key.
+         * @param address 20-byte address.
+         * @param text Optional "0x"-prefixed EIP-55 address; only the 40 digits are kept.
+         *        Updating an entry without text never discards text already stored.
+         */
+        void insert(const Byte* key, const Byte* address, const char* text = nullptr) noexcept {
+            const uint64_t h = hashKey(key);
+            Shard& shard = shardFor(h);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            const size_t setIndex = setFor(h);
+            const uint32_t tag = tagFor(h);
+            Set& set = shard.sets[setIndex];
+            int way = find(shard, setIndex, tag, key);
+            if (way < 0) {
+                way = victim(set, shard.stats);
+                set.tags[way] = tag;
+                set.occupied |= static_cast<uint8_t>(1u << way);
+                set.referenced &= static_cast<uint8_t>(~(1u << way));
+                Entry& entry = shard.entries[setIndex * WAYS + static_cast<size_t>(way)];
+                std::memcpy(entry.key, key, sizeof(entry.key));
+                entry.hasText = false;
+                ++shard.stats.insertions;
+            }
+            Entry& entry = shard.entries[setIndex * WAYS + static_cast<size_t>(way)];
+            std::memcpy(entry.address, address, sizeof(entry.address));
+            if (text) {
+                std::memcpy(entry.text, text + 2, sizeof(entry.text));
+                entry.hasText = true;
+            }
+        }
+
+        // Drop every entry; counters are kept.
+        void clear() noexcept {
+            for (size_t s = 0; s < shardCount_; ++s) {
+                std::lock_guard<std::mutex> lock(shards_[s].mutex);
+                std::fill_n(shards_[s].sets.get(), setsPerShard_, Set{});
+            }
+        }
+
+        // Sum of the per-shard counters.
+        AddressCacheStats stats() const noexcept {
+            AddressCacheStats total;
+            for (size_t s = 0; s < shardCount_; ++s) {
+                std::lock_guard<std::mutex> lock(shards_[s].mutex);
+                total.hits += shards_[s].stats.hits;
+                total.misses += shards_[s].stats.misses;
+                total.insertions += shards_[s].stats.insertions;
+                total.evictions += shards_[s].stats.evictions;
+            }
+            return total;
+        }
+
+        void resetStats() noexcept {
+            for (size_t s = 0; s < shardCount_; ++s) {
+                std::lock_guard<std::mutex> lock(shards_[s].mutex);
+                shards_[s].stats = {};
+            }
+        }
+
+    private:
+        // One cached result: exactly two cache lines.
+        struct alignas(64) Entry {
+            Byte key[64];
+            Byte address[20];
+            char text[40]; // EIP-55 digits without "0x"; valid when hasText
+            bool hasText;
+        };
+        static_assert(sizeof(Entry) == 128, "address cache entries must stay two cache lines");
+
+        // Per-set metadata, scanned before any entry is touched.
+        struct Set {
+            uint32_t tags[WAYS] = {};
+            uint8_t occupied = 0;   // bit per way
+            uint8_t referenced = 0; // CLOCK bit per way
+            uint8_t hand = 0;
+        };
+
+        struct alignas(64) Shard {
+            mutable std::mutex mutex;
+            std::unique_ptr<Set[]> sets;
+            std::unique_ptr<Entry[]> entries;
+            AddressCacheStats stats;
+        };
+
+        // Public keys are curve points, so their bytes are already well mixed; folding all
+        // eight lanes keeps keys that share a prefix apart.
+        static uint64_t hashKey(const Byte* key) noexcept {
+            uint64_t h = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                h = (h ^ keccak_detail::loadLane(key + 8 * i)) * 0x9E3779B97F4A7C15ULL;
+                h ^= h >> 29;
+            }
+            return h;
+        }
+
+        Shard& shardFor(uint64_t h) noexcept { return shards_[h & (shardCount_ - 1)]; }
+        size_t setFor(uint64_t h) const noexcept { return (h >> shardBits_) & (setsPerShard_ - 1); }
+        static uint32_t tagFor(uint64_t h) noexcept { return static_cast<uint32_t>(h >> 32); }
+
+        static int find(const Shard& shard, size_t setIndex, uint32_t tag, const Byte* key) noexcept {
+            const Set& set = shard.sets[setIndex];
+            for (size_t way = 0; way < WAYS; ++way) {
+                if ((set.occupied >> way & 1u) && set.tags[way] == tag &&
+                    std::memcmp(shard.entries[setIndex * WAYS + way].key, key, 64) == 0) {
+                    return static_cast<int>(way);
+                }
+            }
+            return -1;
+        }
+
+        // A free way if there is one, otherwise the first unreferenced way from the hand.
+        static int victim(Set& set, AddressCacheStats& stats) noexcept {
+            if (set.occupied != 0xFF) {
+                return std::countr_one(set.occupied);
+            }
+            while (set.referenced >> set.hand & 1u) {
+                set.referenced &= static_cast<uint8_t>(~(1u << set.hand));
+                set.hand = static_cast<uint8_t>((set.hand + 1) % WAYS);
+            }
+            const int way = set.hand;
+            set.hand = static_cast<uint8_t>((set.hand + 1) % WAYS);
+            ++stats.evictions;
+            return way;
+        }
+
+        size_t shardCount_ = 0;
+        size_t setsPerShard_ = 0;
+        unsigned shardBits_ = 0;
+        std::unique_ptr<Shard[]> shards_;
+    };
+
+} // namespace eth
+
+#endif // ETH_ADDRESS_CACHE_H
@@ -0,0 +1,339 @@
+// address_utils.h - Byte/hex conversion, EIP-55 formatting and vector-of-keys address derivation helpers
+#ifndef ETH_ADDRESS_UTILS_H
+#define ETH_ADDRESS_UTILS_H
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "../keccak/keccak.h"
+#include "../metrics/metrics.h"
+#include "address.h"
+#include "address_batch.h"
+#include "address_cache.h"
+#include "eip55.h"
+#include "hex.h"
+#include "thread_pool.h"
+
+namespace eth {
+
+    using Byte = unsigned char;
+
+    /**
+     * @brief Convert a byte range to a hexadecimal string using a fixed-size buffer.
+     * @param bytes Input bytes.
+     * @param length Number of input bytes.
+     * @param hexBuffer Pre-allocated buffer to store the hex string (must be at least 2*length + 1 bytes).
+     * @note This function is noexcept as it does not throw exceptions.
+     */
+    inline void bytesToHex(const Byte* bytes, size_t length, char* hexBuffer) noexcept {
+        hexEncode(bytes, length, hexBuffer);
+        hexBuffer[2 * length] = '\0'; // Null-terminate the string
+    }
+
+    /**
+     * @brief Convert a vector of bytes to a hexadecimal string using a fixed-size buffer.
+     * @param bytes Input bytes.
+     * @param hexBuffer Pre-allocated buffer to store the hex string (must be at least 2*bytes.size() + 1 bytes).
+     * @note This function is noexcept as it does not throw exceptions.
+     */
+    inline void bytesToHex(const std::vector<Byte>& bytes, char* hexBuffer) noexcept {
+        bytesToHex(bytes.data(), bytes.size(), hexBuffer);
+    }
+
+    /**
+     * @brief Convert a hexadecimal string to a vector of bytes.
+     * @param hex The hex string.
+     * @return std::vector<Byte> Parsed bytes.
+     * @throws std::runtime_error if the input is invalid.
+     * @note Throwing wrapper over hexDecode; hot paths should call hexDecode directly with
+     *       their own output buffer and use the invalid-position mask instead.
+     */
+    inline std::vector<Byte> hexToBytes(std::string_view hex) {
+        if (hex.size() % 2 != 0) {
+            throw std::runtime_error("Hex string has odd length.");
+        }
+        std::vector<Byte> bytes(hex.size() / 2);
+        if (!hexDecode(hex.data(), hex.size(), bytes.data())) {
+            throw std::runtime_error("Hex string contains invalid characters.");
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief Set the letter case of a "0x"-prefixed address from the Keccak-256 of its lowercase hex.
+     * @param addressBuffer Buffer containing the address (42 characters, starting with "0x").
+     * @param hash Keccak-256 digest of the 40 lowercase hex characters.
+     */
+    inline void applyEIP55Checksum(char* addressBuffer, const Byte* hash) noexcept {
+        applyEIP55Case(addressBuffer + 2, hash);
+    }
+
+    /**
+     * @brief Apply EIP-55 checksum encoding to an Ethereum address in-place.
+     * @param addressBuffer Buffer containing the address (must be 42 bytes, starting with "0x").
+     * @throws std::runtime_error if the address format is invalid.
+     * @note The 40-character lowercase address fits one Keccak rate block, so it is hashed
+     *       with the fixed-length single-permutation keccak256Fixed<40>.
+     */
+    inline void toEIP55Address(char* addressBuffer) {
+        // Lowercase copy of the 40 hex characters, validated in the same vector pass
+        char addrLower[40];
+        if (strnlen(addressBuffer, 43) != 42 || addressBuffer[0] != '0' || addressBuffer[1] != 'x' ||
+            !lowercaseHex40(addressBuffer + 2, addrLower)) {
+            throw std::runtime_error("Invalid address format for EIP-55 encoding");
+        }
+
+        std::array<Byte, Keccak256::DIGESTSIZE> hash;
+        keccak256Fixed<40>(reinterpret_cast<const Byte*>(addrLower), hash.data());
+
+        applyEIP55Checksum(addressBuffer, hash.data());
+    }
+
+    /**
+     * @brief Apply EIP-55 checksum encoding to an Ethereum address in-place.
+     * @param addressBuffer Buffer containing the address (must be 42 bytes, starting with "0x").
+     * @param keccak Unused; kept for source compatibility with callers that own a hash object.
+     * @throws std::runtime_error if the address format is invalid.
+     */
+    inline void toEIP55Address(char* addressBuffer, Keccak256& /*keccak*/) {
+        toEIP55Address(addressBuffer);
+    }
+
+    /**
+     * @brief Format an address as EIP-55 text, timing each stage when metrics are on.
+     * @param address The derived address.
+     * @param addressBuffer Buffer to store the resulting address (must be 43 bytes).
+     */
+    inline void formatAddressStages(const Address& address, char* addressBuffer) {
+        {
+            metrics::StageTimer timer(metrics::Stage::HexEncode);
+            address.toHex(addressBuffer);
+        }
+        // The text was just produced in lowercase, so it is hashed as-is without revalidating.
+        metrics::StageTimer timer(metrics::Stage::ChecksumHash);
+        std::array<Byte, Keccak256::DIGESTSIZE> hash;
+        keccak256Fixed<40>(reinterpret_cast<const Byte*>(addressBuffer + 2), hash.data());
+        applyEIP55Checksum(addressBuffer, hash.data());
+    }
+
+    /**
+     * @brief Derive an Ethereum address from an uncompressed public key.
+     * @param publicKey The uncompressed public key.
+     * @return The raw address; format it with Address::toChecksumHex only where text is needed.
+     * @throws std::runtime_error if the public key size is incorrect.
+     * @note The 64-byte key fits one Keccak rate block and is hashed with keccak256Fixed<64>.
+     *       No checksum hash is computed.
+     */
+    inline Address deriveEthereumAddress(const std::vector<Byte>& publicKey) {
+        if (publicKey.size() != 64) {
+            throw std::runtime_error("Invalid public key size. Expected 64 bytes.");
+        }
+        return deriveAddress(publicKey.data());
+    }
+
+    /**
+     * @brief Derive an Ethereum address from an uncompressed public key, reusing cached results.
+     * @param publicKey The uncompressed public key.
+     * @param cache Consulted first; a miss is derived and added (without its text).
+     * @throws std::runtime_error if the public key size is incorrect.
+     */
+    inline Address deriveEthereumAddress(const std::vector<Byte>& publicKey, AddressCache& cache) {
+        if (publicKey.size() != 64) {
+            throw std::runtime_error("Invalid public key size. Expected 64 bytes.");
+        }
+        Address address;
+        if (!cache.lookup(publicKey.data(), address.data())) {
+            address = deriveAddress(publicKey.data());
+            cache.insert(publicKey.data(), address.data());
+        }
+        return address;
+    }
+
+    /**
+     * @brief Derive an Ethereum address from an uncompressed public key.
+     * @param publicKey The uncompressed public key.
+     * @param addressBuffer Buffer to store the resulting address (must be 43 bytes, including "0x" and null terminator).
+     * @throws std::runtime_error if the public key size is incorrect.
+     */
+    inline void deriveEthereumAddress(const std::vector<Byte>& publicKey, char* addressBuffer) {
+        formatAddressStages(deriveEthereumAddress(publicKey), addressBuffer);
+    }
+
+    /**
+     * @brief Derive an Ethereum address from an uncompressed public key.
+     * @param publicKey The uncompressed public key.
+     * @param addressBuffer Buffer to store the resulting address (must be 43 bytes, including "0x" and null terminator).
+     * @param keccak Unused; kept for source compatibility with callers that own a hash object.
+     * @throws std::runtime_error if the public key size is incorrect.
+     */
+    inline void deriveEthereumAddress(const std::vector<Byte>& publicKey, char* addressBuffer, Keccak256& /*keccak*/) {
+        deriveEthereumAddress(publicKey, addressBuffer);
+    }
+
+    /**
+     * @brief Derive an Ethereum address from an uncompressed public key, reusing cached results.
+     * @param publicKey The uncompressed public key.
+     * @param addressBuffer Buffer to store the resulting address (must be 43 bytes, including "0x" and null terminator).
+     * @param cache Consulted first; a miss is derived and added.
+     * @throws std::runtime_error if the public key size is incorrect.
+     */
+    inline void deriveEthereumAddress(const std::vector<Byte>& publicKey, char* addressBuffer, AddressCache& cache) {
+        if (publicKey.size() != 64) {
+            throw std::runtime_error("Invalid public key size. Expected 64 bytes.");
+        }
+        Address address;
+        if (cache.lookup(publicKey.data(), address.data(), addressBuffer)) {
+            return;
+        }
+        address = deriveAddress(publicKey.data());
+        formatAddressStages(address, addressBuffer);
+        cache.insert(publicKey.data(), address.data(), addressBuffer);
+    }
+
+    /**
+     * @brief Derive the addresses for keys [begin, end) on the calling thread.
+     * @note Keys are hashed in chunks of eight through the multi-buffer Keccak-256 kernel
+     *       (8-way AVX-512 / 4-way AVX2, scalar elsewhere), and the chunk is then formatted
+     *       with toEIP55Batch. Key sizes must already be validated.
+     */
+    inline void deriveAddressRange(const std::vector<std::vector<Byte>>& publicKeys,
+                                   std::vector<std::array<char, 43>>& addresses,
+                                   size_t begin, size_t end) noexcept {
+        constexpr size_t chunkSize = address_detail::CHUNK_SIZE;
+        const Byte* keys[chunkSize];
+        Byte raw[chunkSize * 20];
+        for (size_t first = begin; first < end; first += chunkSize) {
+            const size_t count = std::min(chunkSize, end - first);
+            for (size_t k = 0; k < count; ++k) {
+                keys[k] = publicKeys[first + k].data();
+            }
+            address_detail::hashKeyChunk(keys, count, raw);
+            toEIP55Batch(raw, count, addresses.data() + first);
+        }
+    }
+
+    /**
+     * @brief Derive multiple Ethereum addresses in parallel on a persistent thread pool.
+     * @param publicKeys Vector of public keys.
+     * @param addresses Vector of buffers to store the resulting addresses (each must be 43 bytes).
+     * @param pool Pool whose workers run the derivation.
+     * @throws std::runtime_error if the number of public keys and address buffers do not match,
+     *         or if any public key is not 64 bytes.
+     * @note Work is handed out in grains of 64 keys, so each worker writes 64 * 43 bytes
+     *       (exactly 43 cache lines) of output at a time and neighbouring workers only meet
+     *       at grain boundaries. Callers holding contiguous keys should prefer deriveAddresses
+     *       (eth/address_batch.h), which avoids the per-key vectors and the text stage.
+     */
+    inline void deriveMultipleAddresses(const std::vector<std::vector<Byte>>& publicKeys,
+                                          std::vector<std::array<char, 43>>& addresses,
+                                          ThreadPool& pool) {
+        if (publicKeys.size() != addresses.size()) {
+            throw std::runtime_error("Number of public keys and address buffers must match.");
+        }
+        for (const auto& publicKey : publicKeys) {
+            if (publicKey.size() != 64) {
+                throw std::runtime_error("Invalid public key size. Expected 64 bytes.");
+            }
+        }
+        constexpr size_t grain = 64;
+        pool.parallelFor(publicKeys.size(), grain, [&](size_t begin, size_t end) {
+            deriveAddressRange(publicKeys, addresses, begin, end);
+        });
+    }
+
+    /**
+     * @brief Derive multiple Ethereum addresses in parallel, reusing cached results.
+     * @param publicKeys Vector of public keys.
+     * @param addresses Vector of buffers to store the resulting addresses (each must be 43 bytes).
+     * @param cache Consulted per key; misses are derived and added.
+     * @param pool Pool whose workers run the derivation.
+     * @throws std::runtime_error if the number of public keys and address buffers do not match,
+     *         or if any public key is not 64 bytes.
+     */
+    inline void deriveMultipleAddresses(const std::vector<std::vector<Byte>>& publicKeys,
+                                          std::vector<std::array<char, 43>>& addresses,
+                                          AddressCache& cache, ThreadPool& pool) {
+        if (publicKeys.size() != addresses.size()) {
+            throw std::runtime_error("Number of public keys and address buffers must match.");
+        }
+        for (const auto& publicKey : publicKeys) {
+            if (publicKey.size() != 64) {
+                throw std::runtime_error("Invalid public key size. Expected 64 bytes.");
+            }
+        }
+        constexpr size_t grain = 64;
+        pool.parallelFor(publicKeys.size(), grain, [&](size_t begin, size_t end) {
+            constexpr size_t chunkSize = address_detail::CHUNK_SIZE;
+            const Byte* keys[chunkSize];
+            Byte raw[chunkSize * 20];
+            for (size_t first = begin; first < end; first += chunkSize) {
+                const size_t count = std::min(chunkSize, end - first);
+                for (size_t k = 0; k < count; ++k) {
+                    keys[k] = publicKeys[first + k].data();
+                }
+                address_detail::deriveChunkCached(keys, count, raw, addresses.data() + first, cache);
+            }
+        });
+    }
+
+    /**
+     * @brief Derive multiple Ethereum addresses in parallel on the shared thread pool.
+     * @param publicKeys Vector of public keys.
+     * @param addresses Vector of buffers to store the resulting addresses (each must be 43 bytes).
+     * @throws std::runtime_error if the number of public keys and address buffers do not match,
+     *         or if any public key is not 64 bytes.
+     */
+    inline void deriveMultipleAddresses(const std::vector<std::vector<Byte>>& publicKeys,
+                                          std::vector<std::array<char, 43>>& addresses) {
+        deriveMultipleAddresses(publicKeys, addresses, ThreadPool::shared());
+    }
+
+    /**
+     * @brief Derive multiple raw addresses in parallel, without formatting or checksum hashes.
+     * @param publicKeys Vector of public keys.
+     * @param addresses One Address per key.
+     * @param pool Pool whose workers run the derivation.
+     * @throws std::runtime_error if the number of public keys and addresses do not match,
+     *         or if any public key is not 64 bytes.
+     */
+    inline void deriveMultipleAddresses(const std::vector<std::vector<Byte>>& publicKeys,
+                                          std::vector<Address>& addresses, ThreadPool& pool) {
+        if (publicKeys.size() != addresses.size()) {
+            throw std::runtime_error("Number of public keys and addresses must match.");
+        }
+        for (const auto& publicKey : publicKeys) {
+            if (publicKey.size() != 64) {
+                throw std::runtime_error("Invalid public key size. Expected 64 bytes.");
+            }
+        }
+        constexpr size_t grain = 64;
+        pool.parallelFor(publicKeys.size(), grain, [&](size_t begin, size_t end) {
+            constexpr size_t chunkSize = address_detail::CHUNK_SIZE;
+            const Byte* keys[chunkSize];
+            for (size_t first = begin; first < end; first += chunkSize) {
+                const size_t count = std::min(chunkSize, end - first);
+                for (size_t k = 0; k < count; ++k) {
+                    keys[k] = publicKeys[first + k].data();
+                }
+                address_detail::hashKeyChunk(keys, count, addresses[first].data());
+            }
+        });
+    }
+
+    /**
+     * @brief Derive multiple raw addresses in parallel on the shared thread pool.
+     * @throws std::runtime_error if the number of public keys and addresses do not match,
+     *         or if any public key is not 64 bytes.
+     */
+    inline void deriveMultipleAddresses(const std::vector<std::vector<Byte>>& publicKeys,
+                                          std::vector<Address>& addresses) {
+        deriveMultipleAddresses(publicKeys, addresses, ThreadPool::shared());
+    }
+} // namespace eth
+
+#endif // ETH_ADDRESS_UTILS_H
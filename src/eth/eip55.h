@@ -0,0 +1,297 @@
+// eip55.h - Vectorized EIP-55 checksum encoding and verification
+#ifndef ETH_EIP55_H
+#define ETH_EIP55_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <algorithm>
+#include <string_view>
+
+#include "../keccak/keccak.h"
+#include "../keccak/keccak_multibuffer.h"
+#include "../metrics/metrics.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ETH_EIP55_SSE2 1
+#else
+#define ETH_EIP55_SSE2 0
+#endif
+
+namespace eth {
+
+    using Byte = unsigned char;
+
+    namespace eip55_detail {
+
+#if ETH_EIP55_SSE2
+        // Spread 8 bytes into 16 nibbles in text order (high nibble first).
+        inline __m128i expandNibbles(__m128i bytes) noexcept {
+            const __m128i low4 = _mm_set1_epi8(0x0F);
+            const __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), low4);
+            const __m128i lo = _mm_and_si128(bytes, low4);
+            return _mm_unpacklo_epi8(hi, lo);
+        }
+
+        // Lowercase hex digits for 16 nibbles: '0' + n, plus 39 more for n > 9.
+        inline __m128i nibblesToHex(__m128i nibbles) noexcept {
+            const __m128i letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+            return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')),
+                                _mm_and_si128(letters, _mm_set1_epi8('a' - '0' - 10)));
+        }
+
+        // Case bit to clear for 16 characters: set where the text holds a letter
+        // and the matching checksum nibble is 8 or more.
+        inline __m128i caseMask(__m128i text, __m128i hashNibbles) noexcept {
+            const __m128i isLetter = _mm_cmpgt_epi8(text, _mm_set1_epi8('9'));
+            const __m128i upper = _mm_cmpgt_epi8(hashNibbles, _mm_set1_epi8(7));
+            return _mm_and_si128(_mm_and_si128(isLetter, upper), _mm_set1_epi8(0x20));
+        }
+
+        inline __m128i load8(const void* p) noexcept {
+            return _mm_loadl_epi64(static_cast<const __m128i*>(p));
+        }
+
+        inline void store8(void* p, __m128i v) noexcept {
+            _mm_storel_epi64(static_cast<__m128i*>(p), v);
+        }
+#endif
+
+    } // namespace eip55_detail
+
+    /**
+     * @brief Hex-encode a raw 20-byte address with its EIP-55 checksum casing applied.
+     * @param address The 20 address bytes.
+     * @param hash Keccak-256 of the address's 40 lowercase hex characters, or nullptr for plain lowercase.
+     * @param out Destination for exactly 40 characters (no prefix, no terminator).
+     * @note With SSE2 this is three 16-character steps of nibble expansion, a range compare
+     *       and a case-bit blend; other targets use the equivalent scalar loop.
+     */
+    inline void encodeEIP55Hex(const Byte* address, const Byte* hash, char* out) noexcept {
+#if ETH_EIP55_SSE2
+        using namespace eip55_detail;
+        alignas(16) Byte zero[24] = {};
+        const Byte* h = hash ? hash : zero;
+        for (size_t i = 0; i < 16; i += 8) {
+            const __m128i text = nibblesToHex(expandNibbles(load8(address + i)));
+            const __m128i mask = caseMask(text, expandNibbles(load8(h + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_xor_si128(text, mask));
+        }
+        uint32_t tailAddress;
+        uint32_t tailHash;
+        std::memcpy(&tailAddress, address + 16, 4);
+        std::memcpy(&tailHash, h + 16, 4);
+        const __m128i text = nibblesToHex(expandNibbles(_mm_cvtsi32_si128(static_cast<int>(tailAddress))));
+        const __m128i mask = caseMask(text, expandNibbles(_mm_cvtsi32_si128(static_cast<int>(tailHash))));
+        store8(out + 32, _mm_xor_si128(text, mask));
+#else
+        constexpr char hexDigits[] = "0123456789abcdef";
+        for (size_t i = 0; i < 40; ++i) {
+            const int nibble = (i % 2 == 0) ? address[i / 2] >> 4 : address[i / 2] & 0x0F;
+            const int hashNibble = !hash ? 0 : (i % 2 == 0) ? hash[i / 2] >> 4 : hash[i / 2] & 0x0F;
+            char c = hexDigits[nibble];
+            if (nibble > 9 && hashNibble >= 8) {
+                c = static_cast<char>(c & ~0x20);
+            }
+            out[i] = c;
+        }
+#endif
+    }
+
+    /**
+     * @brief Apply EIP-55 casing in place to 40 hex characters of any case.
+     * @param hex40 The 40 hex characters (no prefix).
+     * @param hash Keccak-256 of the lowercase form of those characters.
+     */
+    inline void applyEIP55Case(char* hex40, const Byte* hash) noexcept {
+#if ETH_EIP55_SSE2
+        using namespace eip55_detail;
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+        for (size_t i = 0; i < 40; i += 16) {
+            const bool tail = (i == 32);
+            const __m128i raw = tail ? load8(hex40 + i)
+                                     : _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex40 + i));
+            const __m128i isLetter = _mm_cmpgt_epi8(raw, _mm_set1_epi8('9'));
+            const __m128i lower = _mm_or_si128(raw, _mm_and_si128(isLetter, caseBit));
+            const __m128i out = _mm_xor_si128(lower, caseMask(lower, expandNibbles(load8(hash + i / 2))));
+            if (tail) {
+                store8(hex40 + i, out);
+            } else {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(hex40 + i), out);
+            }
+        }
+#else
+        for (size_t i = 0; i < 40; ++i) {
+            const int hashNibble = (i % 2 == 0) ? hash[i / 2] >> 4 : hash[i / 2] & 0x0F;
+            char c = hex40[i];
+            if (c > '9') {
+                c = static_cast<char>(hashNibble >= 8 ? (c & ~0x20) : (c | 0x20));
+            }
+            hex40[i] = c;
+        }
+#endif
+    }
+
+    /**
+     * @brief Lowercase 40 hex characters and check that they are all hex digits.
+     * @param in The 40 input characters (no prefix); may be mixed case.
+     * @param out Destination for 40 lowercase characters (may alias `in`).
+     * @return true if every character is in [0-9a-fA-F].
+     */
+    inline bool lowercaseHex40(const char* in, char* out) noexcept {
+#if ETH_EIP55_SSE2
+        using namespace eip55_detail;
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+        __m128i invalid = _mm_setzero_si128();
+        alignas(16) char buffer[48] = {};
+        std::memcpy(buffer, in, 40);
+        for (size_t i = 0; i < 48; i += 16) {
+            const __m128i raw = _mm_load_si128(reinterpret_cast<const __m128i*>(buffer + i));
+            const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(raw, _mm_set1_epi8('0' - 1)),
+                                                  _mm_cmplt_epi8(raw, _mm_set1_epi8('9' + 1)));
+            const __m128i folded = _mm_or_si128(raw, caseBit);
+            const __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+                                                   _mm_cmplt_epi8(folded, _mm_set1_epi8('f' + 1)));
+            __m128i valid = _mm_or_si128(isDigit, isLetter);
+            if (i == 32) {
+                // Only the first 8 characters of the last step are real input.
+                valid = _mm_or_si128(valid, _mm_slli_si128(_mm_set1_epi32(-1), 8));
+            }
+            invalid = _mm_or_si128(invalid, _mm_andnot_si128(valid, _mm_set1_epi8(-1)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(buffer + i),
+                            _mm_or_si128(raw, _mm_and_si128(isLetter, caseBit)));
+        }
+        std::memcpy(out, buffer, 40);
+        return _mm_movemask_epi8(invalid) == 0;
+#else
+        bool valid = true;
+        for (size_t i = 0; i < 40; ++i) {
+            const char c = in[i];
+            const char folded = static_cast<char>(c | 0x20);
+            const bool isDigit = c >= '0' && c <= '9';
+            const bool isLetter = folded >= 'a' && folded <= 'f';
+            valid &= isDigit || isLetter;
+            out[i] = isLetter ? folded : c;
+        }
+        return valid;
+#endif
+    }
+
+    /**
+     * @brief Format a raw 20-byte address as a "0x"-prefixed EIP-55 checksummed string.
+     * @param address The 20 address bytes.
+     * @param addressBuffer Destination buffer of at least 43 bytes (NUL-terminated on return).
+     */
+    inline void toEIP55(const Byte* address, char* addressBuffer) noexcept {
+        std::array<Byte, Keccak256::DIGESTSIZE> hash;
+        addressBuffer[0] = '0';
+        addressBuffer[1] = 'x';
+        encodeEIP55Hex(address, nullptr, addressBuffer + 2);
+        keccak256Fixed<40>(reinterpret_cast<const Byte*>(addressBuffer + 2), hash.data());
+        applyEIP55Case(addressBuffer + 2, hash.data());
+        addressBuffer[42] = '\0';
+    }
+
+    /**
+     * @brief Format many raw addresses as EIP-55 checksummed strings.
+     * @param addresses `count` packed 20-byte addresses.
+     * @param count Number of addresses.
+     * @param out `count` 43-byte output buffers.
+     * @note The checksum hashes are computed eight at a time with the multi-buffer Keccak-256.
+     */
+    inline void toEIP55Batch(const Byte* addresses, size_t count, std::array<char, 43>* out) noexcept {
+        metrics::StageTimer timer(metrics::Stage::BatchChecksum, count);
+        constexpr size_t chunkSize = 8;
+        std::array<std::array<Byte, Keccak256::DIGESTSIZE>, chunkSize> hashes;
+        const Byte* messages[chunkSize];
+        Byte* digests[chunkSize];
+        for (size_t k = 0; k < chunkSize; ++k) {
+            digests[k] = hashes[k].data();
+        }
+        for (size_t begin = 0; begin < count; begin += chunkSize) {
+            const size_t n = std::min(chunkSize, count - begin);
+            for (size_t k = 0; k < n; ++k) {
+                char* buffer = out[begin + k].data();
+                buffer[0] = '0';
+                buffer[1] = 'x';
+                encodeEIP55Hex(addresses + 20 * (begin + k), nullptr, buffer + 2);
+                buffer[42] = '\0';
+                messages[k] = reinterpret_cast<const Byte*>(buffer + 2);
+            }
+            keccak256MultiBuffer(messages, 40, digests, n);
+            for (size_t k = 0; k < n; ++k) {
+                applyEIP55Case(out[begin + k].data() + 2, hashes[k].data());
+            }
+        }
+    }
+
+    /**
+     * @brief Check a mixed-case address against its EIP-55 checksum.
+     * @param address 40 hex characters, optionally prefixed with "0x" or "0X".
+     * @return true only if the address is well-formed and its casing matches the checksum exactly.
+     */
+    inline bool verifyEIP55(std::string_view address) noexcept {
+        if (address.size() == 42 && address[0] == '0' && (address[1] == 'x' || address[1] == 'X')) {
+            address.remove_prefix(2);
+        }
+        if (address.size() != 40) {
+            return false;
+        }
+        char expected[40];
+        if (!lowercaseHex40(address.data(), expected)) {
+            return false;
+        }
+        std::array<Byte, Keccak256::DIGESTSIZE> hash;
+        keccak256Fixed<40>(reinterpret_cast<const Byte*>(expected), hash.data());
+        applyEIP55Case(expected, hash.data());
+        return std::memcmp(expected, address.data(), 40) == 0;
+    }
+
+    /**
+     * @brief Check many packed mixed-case addresses against their EIP-55 checksums.
+     * @param records First record; record i starts at records + i * stride.
+     * @param stride Distance in bytes between records (at least 40; at least 42 for "0x"-prefixed records).
+     * @param count Number of records.
+     * @param results `count` outputs: 1 if the record's checksum matches, otherwise 0.
+     * @note A record is treated as prefixed when stride >= 42 and it starts with "0x"/"0X".
+     *       Checksum hashes are computed eight at a time with the multi-buffer Keccak-256.
+     */
+    inline void verifyEIP55Batch(const char* records, size_t stride, size_t count, uint8_t* results) noexcept {
+        constexpr size_t chunkSize = 8;
+        std::array<std::array<char, 40>, chunkSize> lowered;
+        std::array<std::array<Byte, Keccak256::DIGESTSIZE>, chunkSize> hashes;
+        const char* hexStart[chunkSize];
+        const Byte* messages[chunkSize];
+        Byte* digests[chunkSize];
+        size_t slotOf[chunkSize];
+        for (size_t begin = 0; begin < count; begin += chunkSize) {
+            const size_t n = std::min(chunkSize, count - begin);
+            size_t live = 0;
+            for (size_t k = 0; k < n; ++k) {
+                const char* record = records + (begin + k) * stride;
+                if (stride >= 42 && record[0] == '0' && (record[1] == 'x' || record[1] == 'X')) {
+                    record += 2;
+                }
+                results[begin + k] = 0;
+                if (!lowercaseHex40(record, lowered[live].data())) {
+                    continue;
+                }
+                hexStart[live] = record;
+                messages[live] = reinterpret_cast<const Byte*>(lowered[live].data());
+                digests[live] = hashes[live].data();
+                slotOf[live] = begin + k;
+                ++live;
+            }
+            keccak256MultiBuffer(messages, 40, digests, live);
+            for (size_t k = 0; k < live; ++k) {
+                applyEIP55Case(lowered[k].data(), hashes[k].data());
+                results[slotOf[k]] = std::memcmp(lowered[k].data(), hexStart[k], 40) == 0;
+            }
+        }
+    }
+
+} // namespace eth
+
+#endif // ETH_EIP55_H
@@ -0,0 +1,245 @@
+// hex.h - Vectorized hex encoding/decoding with bulk validation
+#ifndef ETH_HEX_H
+#define ETH_HEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+
+#include "../cpu/cpu_dispatch.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ETH_HEX_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define ETH_HEX_HAVE_X86_SIMD 0
+#endif
+
+namespace eth {
+
+    using Byte = unsigned char;
+
+    namespace hex_detail {
+
+        inline constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+        // Lookup table for hex digit conversion (0-15, or -1 if invalid)
+        inline constexpr std::array<int8_t, 256> HEX_VALUES = []() constexpr {
+            std::array<int8_t, 256> table{};
+            for (int i = 0; i < 256; ++i) table[i] = -1;
+            for (int i = '0'; i <= '9'; ++i) table[i] = static_cast<int8_t>(i - '0');
+            for (int i = 'a'; i <= 'f'; ++i) table[i] = static_cast<int8_t>(i - 'a' + 10);
+            for (int i = 'A'; i <= 'F'; ++i) table[i] = static_cast<int8_t>(i - 'A' + 10);
+            return table;
+        }();
+
+        inline void setInvalidBit(uint64_t* invalidMask, size_t position) noexcept {
+            if (invalidMask) {
+                invalidMask[position / 64] |= uint64_t(1) << (position % 64);
+            }
+        }
+
+        inline void encodeScalar(const Byte* bytes, size_t length, char* out) noexcept {
+            for (size_t i = 0; i < length; ++i) {
+                out[2 * i] = HEX_DIGITS[bytes[i] >> 4];
+                out[2 * i + 1] = HEX_DIGITS[bytes[i] & 0x0F];
+            }
+        }
+
+        // Decode `pairs` byte pairs; `firstChar` is the index of hex[0] in the whole input (for the mask).
+        inline bool decodeScalar(const char* hex, size_t pairs, Byte* out,
+                                 uint64_t* invalidMask, size_t firstChar) noexcept {
+            bool valid = true;
+            for (size_t i = 0; i < pairs; ++i) {
+                const int high = HEX_VALUES[static_cast<unsigned char>(hex[2 * i])];
+                const int low = HEX_VALUES[static_cast<unsigned char>(hex[2 * i + 1])];
+                if (high < 0) {
+                    setInvalidBit(invalidMask, firstChar + 2 * i);
+                }
+                if (low < 0) {
+                    setInvalidBit(invalidMask, firstChar + 2 * i + 1);
+                }
+                valid &= (high | low) >= 0;
+                out[i] = static_cast<Byte>(((high & 0x0F) << 4) | (low & 0x0F));
+            }
+            return valid;
+        }
+
+#if ETH_HEX_HAVE_X86_SIMD
+        // 16 bytes -> 32 characters per step: nibble split, PSHUFB digit lookup, interleave.
+        __attribute__((target("ssse3")))
+        inline void encodeSSSE3(const Byte* bytes, size_t length, char* out) noexcept {
+            const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS));
+            const __m128i low4 = _mm_set1_epi8(0x0F);
+            size_t i = 0;
+            for (; i + 16 <= length; i += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+                const __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), low4));
+                const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, low4));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+            }
+            encodeScalar(bytes + i, length - i, out + 2 * i);
+        }
+
+        // Classify 16 characters: returns the validity mask and writes the nibble values.
+        __attribute__((target("ssse3")))
+        inline __m128i classifySSSE3(__m128i c, __m128i& value) noexcept {
+            const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                                  _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+            const __m128i folded = _mm_or_si128(c, _mm_set1_epi8(0x20));
+            const __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+                                                  _mm_cmplt_epi8(folded, _mm_set1_epi8('f' + 1)));
+            value = _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                                 _mm_and_si128(isAlpha, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+            return _mm_or_si128(isDigit, isAlpha);
+        }
+
+        // 32 characters -> 16 bytes per step; nibble pairs are merged with PMADDUBSW (hi * 16 + lo).
+        __attribute__((target("ssse3")))
+        inline bool decodeSSSE3(const char* hex, size_t pairs, Byte* out, uint64_t* invalidMask) noexcept {
+            const __m128i weights = _mm_set1_epi16(0x0110);
+            uint32_t invalidAny = 0;
+            size_t i = 0;
+            for (; i + 16 <= pairs; i += 16) {
+                __m128i v0, v1;
+                const __m128i ok0 = classifySSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i)), v0);
+                const __m128i ok1 = classifySSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i + 16)), v1);
+                const __m128i packed = _mm_packus_epi16(_mm_maddubs_epi16(v0, weights), _mm_maddubs_epi16(v1, weights));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+                const uint32_t invalid = ~(static_cast<uint32_t>(_mm_movemask_epi8(ok0)) |
+                                           (static_cast<uint32_t>(_mm_movemask_epi8(ok1)) << 16));
+                invalidAny |= invalid;
+                if (invalid && invalidMask) {
+                    invalidMask[(2 * i) / 64] |= uint64_t(invalid) << ((2 * i) % 64);
+                }
+            }
+            const bool tailValid = decodeScalar(hex + 2 * i, pairs - i, out + i, invalidMask, 2 * i);
+            return invalidAny == 0 && tailValid;
+        }
+
+        // 32 bytes -> 64 characters per step. The input quadwords are reordered first so the
+        // in-lane unpacks produce contiguous output.
+        __attribute__((target("avx2")))
+        inline void encodeAVX2(const Byte* bytes, size_t length, char* out) noexcept {
+            const __m256i digits = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS)));
+            const __m256i low4 = _mm256_set1_epi8(0x0F);
+            size_t i = 0;
+            for (; i + 32 <= length; i += 32) {
+                const __m256i v = _mm256_permute4x64_epi64(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i)), 0xD8);
+                const __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), low4));
+                const __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, low4));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_unpacklo_epi8(hi, lo));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_unpackhi_epi8(hi, lo));
+            }
+            encodeSSSE3(bytes + i, length - i, out + 2 * i);
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i classifyAVX2(__m256i c, __m256i& value) noexcept {
+            const __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+            const __m256i folded = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+            const __m256i isAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1)),
+                                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), folded));
+            value = _mm256_or_si256(_mm256_and_si256(isDigit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+                                    _mm256_and_si256(isAlpha, _mm256_sub_epi8(folded, _mm256_set1_epi8('a' - 10))));
+            return _mm256_or_si256(isDigit, isAlpha);
+        }
+
+        // 64 characters -> 32 bytes per step; one full word of the invalid mask per step.
+        __attribute__((target("avx2")))
+        inline bool decodeAVX2(const char* hex, size_t pairs, Byte* out, uint64_t* invalidMask) noexcept {
+            const __m256i weights = _mm256_set1_epi16(0x0110);
+            uint64_t invalidAny = 0;
+            size_t i = 0;
+            for (; i + 32 <= pairs; i += 32) {
+                __m256i v0, v1;
+                const __m256i ok0 = classifyAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + 2 * i)), v0);
+                const __m256i ok1 = classifyAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + 2 * i + 32)), v1);
+                const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, weights),
+                                                           _mm256_maddubs_epi16(v1, weights));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+                const uint64_t invalid = ~(static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(ok0))) |
+                                           (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(ok1))) << 32));
+                invalidAny |= invalid;
+                if (invalid && invalidMask) {
+                    invalidMask[(2 * i) / 64] |= invalid;
+                }
+            }
+            uint64_t* tailMask = invalidMask ? invalidMask + (2 * i) / 64 : nullptr;
+            const bool tailValid = decodeSSSE3(hex + 2 * i, pairs - i, out + i, tailMask);
+            return invalidAny == 0 && tailValid;
+        }
+#endif // ETH_HEX_HAVE_X86_SIMD
+
+        struct HexKernels {
+            void (*encode)(const Byte*, size_t, char*) noexcept;
+            bool (*decode)(const char*, size_t, Byte*, uint64_t*) noexcept;
+        };
+
+        inline bool decodeScalarEntry(const char* hex, size_t pairs, Byte* out, uint64_t* invalidMask) noexcept {
+            return decodeScalar(hex, pairs, out, invalidMask, 0);
+        }
+
+        // Pick the widest codec the running CPU (and KECCAK_CPU_LEVEL) allows, once.
+        inline const HexKernels& hexKernels() noexcept {
+            static const HexKernels kernels = []() -> HexKernels {
+#if ETH_HEX_HAVE_X86_SIMD
+                if (cpu::supports(cpu::Feature::AVX2)) {
+                    cpu::recordSelection("hex", "avx2");
+                    return { &encodeAVX2, &decodeAVX2 };
+                }
+                if (cpu::supports(cpu::Feature::SSSE3)) {
+                    cpu::recordSelection("hex", "ssse3");
+                    return { &encodeSSSE3, &decodeSSSE3 };
+                }
+#endif
+                cpu::recordSelection("hex", "scalar");
+                return { &encodeScalar, &decodeScalarEntry };
+            }();
+            return kernels;
+        }
+
+        // Bind the codec during static initialization, before main.
+        inline const HexKernels& boundKernels = hexKernels();
+
+    } // namespace hex_detail
+
+    /**
+     * @brief Hex-encode a byte range (lowercase) into a caller-provided buffer.
+     * @param bytes Input bytes.
+     * @param length Number of input bytes.
+     * @param out Destination for exactly 2*length characters (not NUL-terminated).
+     * @note Encodes 32 bytes per step with AVX2 or 16 with SSSE3, scalar otherwise.
+     */
+    inline void hexEncode(const Byte* bytes, size_t length, char* out) noexcept {
+        hex_detail::hexKernels().encode(bytes, length, out);
+    }
+
+    /**
+     * @brief Decode hex characters into a caller-provided buffer without throwing.
+     * @param hex Input characters (either case, no prefix).
+     * @param hexLength Number of input characters.
+     * @param out Destination for hexLength/2 bytes. Bytes built from invalid characters are unspecified.
+     * @param invalidMask Optional array of (hexLength + 63) / 64 zero-initialized words; bit i is set
+     *        when character i is not a hex digit. A trailing unpaired character is reported invalid.
+     * @return true if every character was a hex digit and hexLength is even.
+     * @note Validates and converts 64 characters per step with AVX2 or 32 with SSSE3.
+     */
+    inline bool hexDecode(const char* hex, size_t hexLength, Byte* out, uint64_t* invalidMask = nullptr) noexcept {
+        const size_t pairs = hexLength / 2;
+        bool valid = hex_detail::hexKernels().decode(hex, pairs, out, invalidMask);
+        if (hexLength % 2 != 0) {
+            hex_detail::setInvalidBit(invalidMask, hexLength - 1);
+            valid = false;
+        }
+        return valid;
+    }
+
+} // namespace eth
+
+#endif // ETH_HEX_H
@@ -0,0 +1,375 @@
+// secp256k1_batch.h - Batch secp256k1 pipelines fused with address derivation
+#ifndef ETH_SECP256K1_BATCH_H
+#define ETH_SECP256K1_BATCH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <span>
+#include <stdexcept>
+#include <secp256k1.h>
+#include <secp256k1_recovery.h>
+
+#include "address_batch.h"
+#include "secp256k1_context.h"
+#include "thread_pool.h"
+
+namespace eth {
+
+    // Raw secp256k1 private key (big-endian scalar).
+    using PrivateKeyBytes = std::array<Byte, 32>;
+
+    // Ethereum recoverable signature: r (32) || s (32) || v (1), with v = recovery id + 27.
+    using SignatureBytes = std::array<Byte, 65>;
+
+    // One ecrecover input: the signed 32-byte hash followed by the 65-byte signature r || s || v.
+    struct RecoverRecord {
+        std::array<Byte, 32> hash;
+        std::array<Byte, 65> signature;
+    };
+    static_assert(sizeof(RecoverRecord) == 97, "RecoverRecord must be tightly packed");
+
+    // Per-record ecrecover outcome.
+    enum class RecoverStatus : uint8_t {
+        Ok = 0,
+        InvalidRecoveryId = 1, // v is not 0, 1, 27 or 28
+        InvalidSignature = 2,  // r or s is not a valid scalar
+        RecoveryFailed = 3,    // no public key recovers from this signature and hash
+    };
+
+    /**
+     * @brief Short name for a recovery status, for logs and CLI output.
+     */
+    inline const char* recoverStatusName(RecoverStatus status) noexcept {
+        switch (status) {
+            case RecoverStatus::Ok: return "ok";
+            case RecoverStatus::InvalidRecoveryId: return "invalid-recovery-id";
+            case RecoverStatus::InvalidSignature: return "invalid-signature";
+            case RecoverStatus::RecoveryFailed: return "recovery-failed";
+        }
+        return "unknown";
+    }
+
+    namespace secp256k1_detail {
+
+        // Create a signing context blinded with fresh randomness, as Secp256k1ContextPool does.
+        inline Secp256k1Context makeRandomizedContext() {
+            Secp256k1Context context(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+            unsigned char seed[32];
+            fillSecureRandom(seed, sizeof(seed));
+            if (!secp256k1_context_randomize(context.get(), seed)) {
+                throw std::runtime_error("Failed to randomize secp256k1 context");
+            }
+            return context;
+        }
+
+        /**
+         * @brief Randomized context owned by the calling thread.
+         * @note Created and blinded on the thread's first use and reused for every later
+         *       batch, so each persistent pool worker pays the setup cost exactly once.
+         * @throws std::runtime_error if the context cannot be created or randomized.
+         */
+        inline secp256k1_context* threadContext() {
+            thread_local Secp256k1Context context = makeRandomizedContext();
+            return context.get();
+        }
+
+        /**
+         * @brief Derive public keys and addresses for private keys [begin, end) on the calling thread.
+         * @param publicKeys Optional destination for the 64-byte keys (nullptr to skip).
+         * @param valid Optional per-key status, 1 for a valid private key (nullptr to skip).
+         * @return Number of invalid private keys in the range; their outputs are zeroed.
+         * @note Public keys are serialized into stack buffers and hashed eight at a time, so
+         *       nothing is allocated per key.
+         */
+        inline size_t derivePrivateKeyRange(const Byte* privateKeys, Byte* addresses, Byte* publicKeys,
+                                            uint8_t* valid, size_t begin, size_t end) {
+            constexpr size_t chunkSize = address_detail::CHUNK_SIZE;
+            secp256k1_context* ctx = threadContext();
+            Byte scratch[chunkSize][64];
+            const Byte* keys[chunkSize];
+            bool ok[chunkSize];
+            size_t invalid = 0;
+            for (size_t first = begin; first < end; first += chunkSize) {
+                const size_t count = std::min(chunkSize, end - first);
+                for (size_t k = 0; k < count; ++k) {
+                    const size_t i = first + k;
+                    Byte* key = publicKeys ? publicKeys + 64 * i : scratch[k];
+                    secp256k1_pubkey pubkey;
+                    ok[k] = secp256k1_ec_pubkey_create(ctx, &pubkey, privateKeys + 32 * i) == 1;
+                    if (ok[k]) {
+                        // Uncompressed form is 0x04 || X || Y; the address hashes X || Y.
+                        Byte serialized[65];
+                        size_t serializedLength = sizeof(serialized);
+                        secp256k1_ec_pubkey_serialize(ctx, serialized, &serializedLength, &pubkey,
+                                                      SECP256K1_EC_UNCOMPRESSED);
+                        std::memcpy(key, serialized + 1, 64);
+                    } else {
+                        std::memset(key, 0, 64);
+                    }
+                    keys[k] = key;
+                }
+                address_detail::hashKeyChunk(keys, count, addresses + 20 * first);
+                for (size_t k = 0; k < count; ++k) {
+                    if (!ok[k]) {
+                        std::memset(addresses + 20 * (first + k), 0, 20);
+                        ++invalid;
+                    }
+                    if (valid) {
+                        valid[first + k] = ok[k];
+                    }
+                }
+            }
+            return invalid;
+        }
+
+        // Recover the signer's 64-byte public key from one record.
+        inline RecoverStatus recoverPublicKey(const secp256k1_context* ctx, const RecoverRecord& record,
+                                              Byte* publicKey) noexcept {
+            int v = record.signature[64];
+            if (v >= 27) {
+                v -= 27;
+            }
+            if (v != 0 && v != 1) {
+                return RecoverStatus::InvalidRecoveryId;
+            }
+            secp256k1_ecdsa_recoverable_signature signature;
+            if (!secp256k1_ecdsa_recoverable_signature_parse_compact(ctx, &signature, record.signature.data(), v)) {
+                return RecoverStatus::InvalidSignature;
+            }
+            secp256k1_pubkey pubkey;
+            if (!secp256k1_ecdsa_recover(ctx, &pubkey, &signature, record.hash.data())) {
+                return RecoverStatus::RecoveryFailed;
+            }
+            Byte serialized[65];
+            size_t serializedLength = sizeof(serialized);
+            secp256k1_ec_pubkey_serialize(ctx, serialized, &serializedLength, &pubkey, SECP256K1_EC_UNCOMPRESSED);
+            std::memcpy(publicKey, serialized + 1, 64);
+            return RecoverStatus::Ok;
+        }
+
+        /**
+         * @brief Recover sender addresses for records [begin, end) on the calling thread.
+         * @return Number of records that did not recover; their addresses are zeroed.
+         */
+        inline size_t recoverRange(const RecoverRecord* records, Byte* addresses, RecoverStatus* status,
+                                   size_t begin, size_t end) {
+            constexpr size_t chunkSize = address_detail::CHUNK_SIZE;
+            const secp256k1_context* ctx = threadContext();
+            Byte scratch[chunkSize][64];
+            const Byte* keys[chunkSize];
+            size_t failed = 0;
+            for (size_t k = 0; k < chunkSize; ++k) {
+                keys[k] = scratch[k];
+            }
+            for (size_t first = begin; first < end; first += chunkSize) {
+                const size_t count = std::min(chunkSize, end - first);
+                for (size_t k = 0; k < count; ++k) {
+                    status[first + k] = recoverPublicKey(ctx, records[first + k], scratch[k]);
+                    if (status[first + k] != RecoverStatus::Ok) {
+                        std::memset(scratch[k], 0, 64);
+                    }
+                }
+                address_detail::hashKeyChunk(keys, count, addresses + 20 * first);
+                for (size_t k = 0; k < count; ++k) {
+                    if (status[first + k] != RecoverStatus::Ok) {
+                        std::memset(addresses + 20 * (first + k), 0, 20);
+                        ++failed;
+                    }
+                }
+            }
+            return failed;
+        }
+
+    } // namespace secp256k1_detail
+
+    /**
+     * @brief Derive addresses (and optionally public keys) from private keys in one pass.
+     * @param privateKeys 32-byte private keys, packed back to back.
+     * @param addresses One 20-byte output per key.
+     * @param publicKeys Empty, or one 64-byte output per key (X || Y, 0x04 prefix stripped).
+     * @param valid Empty, or one status byte per key: 1 if the private key is valid, else 0.
+     * @param pool Pool whose workers run the pipeline; each worker owns one secp256k1 context.
+     * @return Number of invalid private keys (zero or not below the curve order). Their
+     *         address and public key outputs are zeroed.
+     * @throws std::invalid_argument if a non-empty output span differs in length from privateKeys.
+     * @throws std::runtime_error if a worker cannot create its secp256k1 context.
+     */
+    inline size_t deriveAddressesFromPrivateKeys(std::span<const PrivateKeyBytes> privateKeys,
+                                                 std::span<AddressBytes> addresses,
+                                                 std::span<PublicKeyBytes> publicKeys,
+                                                 std::span<uint8_t> valid,
+                                                 ThreadPool& pool) {
+        if (addresses.size() != privateKeys.size() ||
+            (!publicKeys.empty() && publicKeys.size() != privateKeys.size()) ||
+            (!valid.empty() && valid.size() != privateKeys.size())) {
+            throw std::invalid_argument("Number of private keys and outputs must match.");
+        }
+        const Byte* in = reinterpret_cast<const Byte*>(privateKeys.data());
+        Byte* out = reinterpret_cast<Byte*>(addresses.data());
+        Byte* keysOut = publicKeys.empty() ? nullptr : reinterpret_cast<Byte*>(publicKeys.data());
+        uint8_t* validOut = valid.empty() ? nullptr : valid.data();
+        std::atomic<size_t> invalid{0};
+        pool.parallelFor(privateKeys.size(), address_detail::GRAIN, [&](size_t begin, size_t end) {
+            const size_t rangeInvalid =
+                secp256k1_detail::derivePrivateKeyRange(in, out, keysOut, validOut, begin, end);
+            if (rangeInvalid) {
+                invalid.fetch_add(rangeInvalid, std::memory_order_relaxed);
+            }
+        });
+        return invalid.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Derive addresses from private keys on the given pool.
+     * @return Number of invalid private keys; their addresses are zeroed.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline size_t deriveAddressesFromPrivateKeys(std::span<const PrivateKeyBytes> privateKeys,
+                                                 std::span<AddressBytes> addresses, ThreadPool& pool) {
+        return deriveAddressesFromPrivateKeys(privateKeys, addresses, {}, {}, pool);
+    }
+
+    /**
+     * @brief Derive addresses from private keys on the shared pool.
+     * @return Number of invalid private keys; their addresses are zeroed.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline size_t deriveAddressesFromPrivateKeys(std::span<const PrivateKeyBytes> privateKeys,
+                                                 std::span<AddressBytes> addresses) {
+        return deriveAddressesFromPrivateKeys(privateKeys, addresses, ThreadPool::shared());
+    }
+
+    /**
+     * @brief Recover the sender address of many signed hashes in parallel (batch ecrecover).
+     * @param records Packed (hash, signature) records.
+     * @param addresses One 20-byte output per record; zeroed for records that fail.
+     * @param status One status per record; failures are reported here, never logged.
+     * @param pool Pool whose workers run recovery; each worker owns one secp256k1 context.
+     * @return Number of records whose status is not RecoverStatus::Ok.
+     * @throws std::invalid_argument if the spans differ in length.
+     * @throws std::runtime_error if a worker cannot create its secp256k1 context.
+     * @note Recovered keys stay in stack buffers and are hashed eight at a time with the
+     *       multi-buffer Keccak-256; nothing is allocated per record.
+     */
+    inline size_t recoverAddresses(std::span<const RecoverRecord> records, std::span<AddressBytes> addresses,
+                                   std::span<RecoverStatus> status, ThreadPool& pool) {
+        if (addresses.size() != records.size() || status.size() != records.size()) {
+            throw std::invalid_argument("Number of records, addresses and status codes must match.");
+        }
+        Byte* out = reinterpret_cast<Byte*>(addresses.data());
+        std::atomic<size_t> failed{0};
+        pool.parallelFor(records.size(), address_detail::GRAIN, [&](size_t begin, size_t end) {
+            const size_t rangeFailed =
+                secp256k1_detail::recoverRange(records.data(), out, status.data(), begin, end);
+            if (rangeFailed) {
+                failed.fetch_add(rangeFailed, std::memory_order_relaxed);
+            }
+        });
+        return failed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Batch ecrecover on the shared pool.
+     * @return Number of records whose status is not RecoverStatus::Ok.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline size_t recoverAddresses(std::span<const RecoverRecord> records, std::span<AddressBytes> addresses,
+                                   std::span<RecoverStatus> status) {
+        return recoverAddresses(records, addresses, status, ThreadPool::shared());
+    }
+
+    /**
+     * @brief Sign many 32-byte hashes, writing packed 65-byte recoverable signatures.
+     * @param hashes Message hashes to sign.
+     * @param privateKeys Either one key (used for every hash) or one key per hash.
+     * @param signatures Caller-provided packed output of 65 bytes per hash (r || s || v, v = recid + 27).
+     * @param valid Empty, or one status byte per hash: 1 if signed, 0 if the key was invalid.
+     * @param contexts Pool of pre-randomized contexts; each grain of work leases one.
+     * @param pool Pool whose workers do the signing.
+     * @return Number of hashes that could not be signed; their signatures are zeroed.
+     * @throws std::invalid_argument if the output sizes or key count do not match.
+     * @note Nonces are RFC 6979 deterministic. Nothing is allocated per signature.
+     */
+    inline size_t signHashes(std::span<const std::array<Byte, 32>> hashes,
+                             std::span<const PrivateKeyBytes> privateKeys,
+                             std::span<Byte> signatures, std::span<uint8_t> valid,
+                             Secp256k1ContextPool& contexts, ThreadPool& pool) {
+        if ((privateKeys.size() != 1 && privateKeys.size() != hashes.size()) ||
+            signatures.size() != hashes.size() * sizeof(SignatureBytes) ||
+            (!valid.empty() && valid.size() != hashes.size())) {
+            throw std::invalid_argument("Number of hashes, private keys and signature bytes must match.");
+        }
+        const size_t keyStride = privateKeys.size() == 1 ? 0 : 1;
+        std::atomic<size_t> failed{0};
+        pool.parallelFor(hashes.size(), address_detail::GRAIN, [&](size_t begin, size_t end) {
+            const auto lease = contexts.acquire();
+            const secp256k1_context* ctx = lease.get();
+            size_t rangeFailed = 0;
+            for (size_t i = begin; i < end; ++i) {
+                Byte* out = signatures.data() + i * sizeof(SignatureBytes);
+                secp256k1_ecdsa_recoverable_signature signature;
+                int recoveryId = 0;
+                const bool ok = secp256k1_ecdsa_sign_recoverable(ctx, &signature, hashes[i].data(),
+                                                                 privateKeys[i * keyStride].data(),
+                                                                 nullptr, nullptr) == 1;
+                if (ok) {
+                    secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, out, &recoveryId, &signature);
+                    out[64] = static_cast<Byte>(recoveryId + 27);
+                } else {
+                    std::memset(out, 0, sizeof(SignatureBytes));
+                    ++rangeFailed;
+                }
+                if (!valid.empty()) {
+                    valid[i] = ok;
+                }
+            }
+            if (rangeFailed) {
+                failed.fetch_add(rangeFailed, std::memory_order_relaxed);
+            }
+        });
+        return failed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sign many hashes with the shared context pool and the shared thread pool.
+     * @return Number of hashes that could not be signed; their signatures are zeroed.
+     * @throws std::invalid_argument if the output sizes or key count do not match.
+     */
+    inline size_t signHashes(std::span<const std::array<Byte, 32>> hashes,
+                             std::span<const PrivateKeyBytes> privateKeys, std::span<Byte> signatures) {
+        return signHashes(hashes, privateKeys, signatures, {}, Secp256k1ContextPool::shared(),
+                          ThreadPool::shared());
+    }
+
+    /**
+     * @brief Generate valid private keys in bulk.
+     * @param out Keys to fill.
+     * @param contexts Pool providing the context used to validate the keys.
+     * @throws std::runtime_error if the system entropy source fails.
+     * @note One entropy read covers the whole batch; the rare candidate outside [1, n) is redrawn.
+     */
+    inline void generatePrivateKeys(std::span<PrivateKeyBytes> out, Secp256k1ContextPool& contexts) {
+        fillSecureRandom(out.data(), out.size_bytes());
+        const auto lease = contexts.acquire();
+        for (auto& key : out) {
+            while (!secp256k1_ec_seckey_verify(lease.get(), key.data())) {
+                fillSecureRandom(key.data(), key.size());
+            }
+        }
+    }
+
+    /**
+     * @brief Generate valid private keys in bulk using the shared context pool.
+     * @throws std::runtime_error if the system entropy source fails.
+     */
+    inline void generatePrivateKeys(std::span<PrivateKeyBytes> out) {
+        generatePrivateKeys(out, Secp256k1ContextPool::shared());
+    }
+
+} // namespace eth
+
+#endif // ETH_SECP256K1_BATCH_H
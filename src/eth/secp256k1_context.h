@@ -0,0 +1,194 @@
+// secp256k1_context.h - RAII ownership of a libsecp256k1 context
+#ifndef ETH_SECP256K1_CONTEXT_H
+#define ETH_SECP256K1_CONTEXT_H
+
+#include <cstddef>
+#include <cerrno>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <secp256k1.h>
+
+#if defined(__linux__)
+#include <sys/random.h>
+#endif
+
+// Custom deleter for the secp256k1 context
+struct Secp256k1Deleter {
+    void operator()(secp256k1_context* ctx) const noexcept {
+        if (ctx) {
+            secp256k1_context_destroy(ctx);
+        }
+    }
+};
+
+// RAII wrapper for secp256k1_context using std::unique_ptr
+class Secp256k1Context {
+public:
+    // Constructor acquires the secp256k1 context with specified flags.
+    explicit Secp256k1Context(unsigned int flags)
+        : ctx_(secp256k1_context_create(flags)) {
+        if (!ctx_) {
+            throw std::runtime_error("Failed to create secp256k1 context");
+        }
+    }
+
+    // Overload operator-> for direct pointer access.
+    secp256k1_context* operator->() const noexcept {
+        return ctx_.get();
+    }
+
+    // Provide access to the underlying raw pointer.
+    secp256k1_context* get() const noexcept { return ctx_.get(); }
+
+    // Deleted copy constructor and copy assignment operator to prevent copying.
+    Secp256k1Context(const Secp256k1Context&) = delete;
+    Secp256k1Context& operator=(const Secp256k1Context&) = delete;
+
+    // Default move constructor and move assignment operator suffice.
+    Secp256k1Context(Secp256k1Context&&) noexcept = default;
+    Secp256k1Context& operator=(Secp256k1Context&&) noexcept = default;
+
+    // Optional swap method for efficient resource exchange.
+    void swap(Secp256k1Context& other) noexcept {
+        ctx_.swap(other.ctx_);
+    }
+
+    // Optional conversion operator to secp256k1_context* for seamless integration.
+    operator secp256k1_context*() const noexcept {
+        return ctx_.get();
+    }
+
+private:
+    std::unique_ptr<secp256k1_context, Secp256k1Deleter> ctx_;
+};
+
+namespace eth {
+
+    /**
+     * @brief Fill a buffer with cryptographically secure random bytes.
+     * @throws std::runtime_error if the system entropy source fails.
+     * @note Uses getrandom() on Linux and std::random_device elsewhere.
+     */
+    inline void fillSecureRandom(void* out, size_t size) {
+        auto* bytes = static_cast<unsigned char*>(out);
+#if defined(__linux__)
+        while (size > 0) {
+            const ssize_t n = getrandom(bytes, size, 0);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("getrandom failed");
+            }
+            bytes += n;
+            size -= static_cast<size_t>(n);
+        }
+#else
+        std::random_device device;
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<unsigned char>(device());
+        }
+#endif
+    }
+
+    /**
+     * @brief Fixed set of randomized secp256k1 contexts handed out to workers without locks.
+     *
+     * Every context is created and blinded with secp256k1_context_randomize exactly once,
+     * at construction. acquire() claims a free slot with a single atomic exchange, starting
+     * from a per-thread hint so concurrent workers rarely probe the same slot; the returned
+     * Lease puts the context back when it goes out of scope.
+     */
+    class Secp256k1ContextPool {
+        struct alignas(64) Slot {
+            Secp256k1Context context{ SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY };
+            std::atomic<bool> busy{ false };
+        };
+
+    public:
+        // Exclusive use of one pooled context; move-only, released on destruction.
+        class Lease {
+        public:
+            Lease(Lease&& other) noexcept : slot_(std::exchange(other.slot_, nullptr)) {}
+            Lease& operator=(Lease&&) = delete;
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            ~Lease() {
+                if (slot_) {
+                    slot_->busy.store(false, std::memory_order_release);
+                }
+            }
+
+            secp256k1_context* get() const noexcept { return slot_->context.get(); }
+
+        private:
+            friend class Secp256k1ContextPool;
+            explicit Lease(Slot* slot) noexcept : slot_(slot) {}
+            Slot* slot_;
+        };
+
+        /**
+         * @brief Create and randomize `size` contexts.
+         * @param size Number of contexts (0 = std::thread::hardware_concurrency()).
+         * @throws std::runtime_error if a context cannot be created or randomized.
+         */
+        explicit Secp256k1ContextPool(size_t size = 0)
+            : size_(size ? size : std::max(1u, std::thread::hardware_concurrency())),
+              slots_(std::make_unique<Slot[]>(size_)) {
+            unsigned char seed[32];
+            for (size_t i = 0; i < size_; ++i) {
+                fillSecureRandom(seed, sizeof(seed));
+                if (!secp256k1_context_randomize(slots_[i].context.get(), seed)) {
+                    throw std::runtime_error("Failed to randomize secp256k1 context");
+                }
+            }
+        }
+
+        Secp256k1ContextPool(const Secp256k1ContextPool&) = delete;
+        Secp256k1ContextPool& operator=(const Secp256k1ContextPool&) = delete;
+
+        /**
+         * @brief Claim a context for exclusive use.
+         * @note Lock-free; if every context is leased the caller yields and retries, so size
+         *       the pool to at least the number of concurrent signers.
+         */
+        Lease acquire() noexcept {
+            thread_local const size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+            while (true) {
+                for (size_t i = 0; i < size_; ++i) {
+                    Slot& slot = slots_[(hint + i) % size_];
+                    if (!slot.busy.load(std::memory_order_relaxed) &&
+                        !slot.busy.exchange(true, std::memory_order_acquire)) {
+                        return Lease(&slot);
+                    }
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        // Number of contexts in the pool.
+        size_t size() const noexcept { return size_; }
+
+        /**
+         * @brief Process-wide pool used by the batch signing APIs when no pool is passed.
+         * @note Created on first use with one context per hardware thread.
+         */
+        static Secp256k1ContextPool& shared() {
+            static Secp256k1ContextPool pool;
+            return pool;
+        }
+
+    private:
+        size_t size_;
+        std::unique_ptr<Slot[]> slots_;
+    };
+
+} // namespace eth
+
+#endif // ETH_SECP256K1_CONTEXT_H
@@ -0,0 +1,239 @@
+// storage_slots.h - Solidity storage slot calculation for mappings and dynamic arrays
+#ifndef ETH_STORAGE_SLOTS_H
+#define ETH_STORAGE_SLOTS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+#include "../keccak/keccak.h"
+#include "../keccak/keccak_multibuffer.h"
+#include "hex.h"
+#include "thread_pool.h"
+
+namespace eth {
+
+    using Byte = unsigned char;
+
+    // One 256-bit EVM word, big-endian (storage slots, padded mapping keys, array indices).
+    using Word = std::array<Byte, 32>;
+
+    namespace slot_detail {
+
+        // Slots hashed per multi-buffer call; matches the widest (8-way AVX-512) kernel.
+        inline constexpr size_t CHUNK_SIZE = 8;
+
+        // Keys handed to a worker at a time.
+        inline constexpr size_t GRAIN = 1024;
+
+        // GCC/Clang 128-bit integer; __extension__ keeps -Wpedantic quiet about it.
+        __extension__ typedef unsigned __int128 uint128_t;
+
+        // a += b * multiplier over big-endian 256-bit words (wrapping, as the EVM does).
+        inline void addMultiple(Word& a, const Word& b, uint64_t multiplier) noexcept {
+            uint128_t carry = 0;
+            for (int lane = 3; lane >= 0; --lane) {
+                uint64_t x = 0;
+                uint64_t y = 0;
+                for (int j = 0; j < 8; ++j) {
+                    x = (x << 8) | a[8 * lane + j];
+                    y = (y << 8) | b[8 * lane + j];
+                }
+                const uint128_t sum = static_cast<uint128_t>(y) * multiplier + x + carry;
+                const uint64_t low = static_cast<uint64_t>(sum);
+                carry = sum >> 64;
+                for (int j = 7; j >= 0; --j) {
+                    a[8 * lane + j] = static_cast<Byte>(low >> (8 * (7 - j)));
+                }
+            }
+        }
+
+        /**
+         * @brief Hash keys [begin, end) against one base slot on the calling thread.
+         * @note Every message is pad32(key) ++ pad32(slot): 64 bytes, one Keccak block. The
+         *       slot half never changes, so it is written once into each lane's message
+         *       buffer and only the key half is copied per key.
+         */
+        inline void mappingRange(const Word& slot, const Word* keys, Word* out, size_t begin, size_t end) noexcept {
+            alignas(64) Byte messages[CHUNK_SIZE][64];
+            const Byte* in[CHUNK_SIZE];
+            Byte* digests[CHUNK_SIZE];
+            for (size_t k = 0; k < CHUNK_SIZE; ++k) {
+                std::memcpy(messages[k] + 32, slot.data(), 32);
+                in[k] = messages[k];
+            }
+            for (size_t first = begin; first < end; first += CHUNK_SIZE) {
+                const size_t count = std::min(CHUNK_SIZE, end - first);
+                for (size_t k = 0; k < count; ++k) {
+                    std::memcpy(messages[k], keys[first + k].data(), 32);
+                    digests[k] = out[first + k].data();
+                }
+                keccak256MultiBuffer(in, 64, digests, count);
+            }
+        }
+
+    } // namespace slot_detail
+
+    /**
+     * @brief Left-pad an unsigned integer to a 32-byte word (uint / slot number encoding).
+     */
+    inline Word toWord(uint64_t value) noexcept {
+        Word word{};
+        for (int i = 0; i < 8; ++i) {
+            word[31 - i] = static_cast<Byte>(value >> (8 * i));
+        }
+        return word;
+    }
+
+    /**
+     * @brief Left-pad a 20-byte address to a 32-byte word (address key encoding).
+     */
+    inline Word toWord(const std::array<Byte, 20>& address) noexcept {
+        Word word{};
+        std::memcpy(word.data() + 12, address.data(), 20);
+        return word;
+    }
+
+    /**
+     * @brief Slot of mapping[key] for a mapping stored at `slot`: keccak256(pad32(key) ++ pad32(slot)).
+     * @param key The key already encoded as a 32-byte word (see toWord).
+     */
+    inline Word mappingSlot(const Word& key, const Word& slot) noexcept {
+        Byte message[64];
+        std::memcpy(message, key.data(), 32);
+        std::memcpy(message + 32, slot.data(), 32);
+        Word out;
+        keccak256Fixed<64>(message, out.data());
+        return out;
+    }
+
+    /**
+     * @brief Slot of a nested mapping entry, e.g. m[a][b] is nestedMappingSlot({a, b}, slot).
+     * @param keys Keys from the outermost mapping inwards.
+     */
+    inline Word nestedMappingSlot(std::span<const Word> keys, const Word& slot) noexcept {
+        Word current = slot;
+        for (const Word& key : keys) {
+            current = mappingSlot(key, current);
+        }
+        return current;
+    }
+
+    /**
+     * @brief First data slot of a dynamic array (or bytes/string) stored at `slot`: keccak256(pad32(slot)).
+     */
+    inline Word arrayDataSlot(const Word& slot) noexcept {
+        Word out;
+        keccak256Fixed<32>(slot.data(), out.data());
+        return out;
+    }
+
+    /**
+     * @brief Slot of array[index]: arrayDataSlot(slot) + index * slotsPerElement (mod 2^256).
+     * @param slotsPerElement Storage slots one element occupies (1 for value types up to 32 bytes).
+     * @note Packed elements smaller than 16 bytes share slots; compute their slot from
+     *       index / elementsPerSlot and the offset within it separately.
+     */
+    inline Word arrayElementSlot(const Word& slot, const Word& index, uint64_t slotsPerElement = 1) noexcept {
+        Word out = arrayDataSlot(slot);
+        slot_detail::addMultiple(out, index, slotsPerElement);
+        return out;
+    }
+
+    inline Word arrayElementSlot(const Word& slot, uint64_t index, uint64_t slotsPerElement = 1) noexcept {
+        return arrayElementSlot(slot, toWord(index), slotsPerElement);
+    }
+
+    /**
+     * @brief Parse a word written as 0x-prefixed hex (at most 64 digits) or as a decimal number.
+     * @return false if the text is empty, malformed or does not fit in 256 bits.
+     * @note Short values are left-padded, so a 40-digit address parses to its key encoding.
+     */
+    inline bool parseWord(std::string_view text, Word& word) noexcept {
+        word.fill(0);
+        if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+            text.remove_prefix(2);
+            if (text.size() > 64) {
+                return false;
+            }
+            char digits[64];
+            const size_t pad = 64 - text.size();
+            std::memset(digits, '0', pad);
+            std::memcpy(digits + pad, text.data(), text.size());
+            return hexDecode(digits, sizeof(digits), word.data());
+        }
+        if (text.empty()) {
+            return false;
+        }
+        for (char c : text) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            // word = word * 10 + digit, rejecting overflow past 2^256 - 1.
+            unsigned carry = static_cast<unsigned>(c - '0');
+            for (int i = 31; i >= 0; --i) {
+                const unsigned value = word[i] * 10u + carry;
+                word[i] = static_cast<Byte>(value);
+                carry = value >> 8;
+            }
+            if (carry != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Batch mapping slots: out[i] = keccak256(pad32(keys[i]) ++ pad32(slot)).
+     * @param slot Storage slot of the mapping (for nested mappings, the nestedMappingSlot of
+     *        the outer keys, computed once).
+     * @param keys Keys encoded as 32-byte words.
+     * @param out One slot hash per key.
+     * @param pool Pool whose workers run the hashing.
+     * @throws std::invalid_argument if the spans differ in length.
+     * @note Each key is one 64-byte block, hashed eight at a time with the multi-buffer Keccak-256.
+     */
+    inline void mappingSlots(const Word& slot, std::span<const Word> keys, std::span<Word> out, ThreadPool& pool) {
+        if (keys.size() != out.size()) {
+            throw std::invalid_argument("Number of keys and output slots must match.");
+        }
+        pool.parallelFor(keys.size(), slot_detail::GRAIN, [&](size_t begin, size_t end) {
+            slot_detail::mappingRange(slot, keys.data(), out.data(), begin, end);
+        });
+    }
+
+    /**
+     * @brief Batch mapping slots on the shared pool.
+     * @throws std::invalid_argument if the spans differ in length.
+     */
+    inline void mappingSlots(const Word& slot, std::span<const Word> keys, std::span<Word> out) {
+        mappingSlots(slot, keys, out, ThreadPool::shared());
+    }
+
+    /**
+     * @brief Batch array element slots: out[i] = arrayElementSlot(slot, indices[i], slotsPerElement).
+     * @param slot Storage slot of the array (for an array inside a mapping, its mappingSlot).
+     * @param indices Element indices encoded as 32-byte words.
+     * @throws std::invalid_argument if the spans differ in length.
+     * @note The data slot is hashed once; each element is then a 256-bit multiply-add.
+     */
+    inline void arrayElementSlots(const Word& slot, std::span<const Word> indices, std::span<Word> out,
+                                  uint64_t slotsPerElement = 1) {
+        if (indices.size() != out.size()) {
+            throw std::invalid_argument("Number of indices and output slots must match.");
+        }
+        const Word data = arrayDataSlot(slot);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            out[i] = data;
+            slot_detail::addMultiple(out[i], indices[i], slotsPerElement);
+        }
+    }
+
+} // namespace eth
+
+#endif // ETH_STORAGE_SLOTS_H
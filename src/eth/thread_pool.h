@@ -0,0 +1,295 @@
+// thread_pool.h - Persistent work-stealing thread pool for batch derivation
+#ifndef ETH_THREAD_POOL_H
+#define ETH_THREAD_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../metrics/metrics.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace eth {
+
+    /**
+     * @brief Long-lived pool of workers that run index ranges with work stealing.
+     *
+     * parallelFor() splits [0, count) into one contiguous range per worker and
+     * pushes each onto that worker's deque. Owners carve `grain`-sized chunks
+     * off the front of their own deque; idle workers steal the back half of
+     * another worker's last pending range. Workers persist across calls, so
+     * repeated small batches pay no thread creation cost.
+     */
+    class ThreadPool {
+    public:
+        struct Options {
+            size_t workers = 0;       // 0 = std::thread::hardware_concurrency()
+            bool pinToCores = false;  // pin worker i to CPU i (Linux only; ignored elsewhere)
+        };
+
+        ThreadPool() : ThreadPool(Options{}) {}
+
+        explicit ThreadPool(Options options) {
+            size_t count = options.workers ? options.workers
+                                           : std::max<size_t>(1, std::thread::hardware_concurrency());
+            queues_ = std::make_unique<WorkerQueue[]>(count);
+            counters_ = metrics::registerWorkerGroup(count);
+            threads_.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                threads_.emplace_back([this, i] { workerLoop(i); });
+                if (options.pinToCores) {
+                    pinToCore(threads_.back(), i);
+                }
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto& thread : threads_) {
+                thread.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Number of worker threads.
+        size_t size() const noexcept { return threads_.size(); }
+
+        /**
+         * @brief Run body(begin, end) over [0, count) in chunks of at most `grain` indices.
+         * @param count Number of indices.
+         * @param grain Chunk size; also the alignment of chunk boundaries.
+         * @param body Callable taking (size_t begin, size_t end).
+         * @throws Rethrows the first exception thrown by any chunk, after all chunks finish.
+         * @note Blocks until every chunk has run. Calls from different threads are serialized;
+         *       calling parallelFor from inside a body on the same pool deadlocks.
+         */
+        template <typename Body>
+        void parallelFor(size_t count, size_t grain, Body&& body) {
+            grain = std::max<size_t>(1, grain);
+            if (count <= grain || threads_.size() == 1) {
+                for (size_t begin = 0; begin < count; begin += grain) {
+                    body(begin, std::min(count, begin + grain));
+                }
+                return;
+            }
+            using BodyType = std::remove_reference_t<Body>;
+            run(count, grain, const_cast<void*>(static_cast<const void*>(&body)),
+                [](void* context, size_t begin, size_t end) {
+                    (*static_cast<BodyType*>(context))(begin, end);
+                });
+        }
+
+        /**
+         * @brief Process-wide pool used by the batch APIs when no pool is passed.
+         * @note Created on first use with default options (one worker per hardware thread).
+         */
+        static ThreadPool& shared() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+    private:
+        struct Range {
+            size_t begin;
+            size_t end;
+        };
+
+        // Padded to a cache line so neighbouring workers' deque locks do not false-share.
+        struct alignas(64) WorkerQueue {
+            std::mutex mutex;
+            std::deque<Range> ranges;
+        };
+
+        using Invoker = void (*)(void*, size_t, size_t);
+
+        static void pinToCore(std::thread& thread, size_t index) {
+#if defined(__linux__)
+            const unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(index % cpus, &set);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+            (void)thread;
+            (void)index;
+#endif
+        }
+
+        void run(size_t count, size_t grain, void* context, Invoker invoke) {
+            std::lock_guard<std::mutex> submitLock(submitMutex_);
+            context_ = context;
+            invoke_ = invoke;
+            grain_ = grain;
+            error_ = nullptr;
+            remaining_.store(count, std::memory_order_relaxed);
+
+            // One contiguous, grain-aligned range per worker.
+            const size_t workers = threads_.size();
+            const size_t chunks = (count + grain - 1) / grain;
+            const size_t chunksPerWorker = (chunks + workers - 1) / workers;
+            for (size_t i = 0; i < workers; ++i) {
+                const size_t begin = std::min(count, i * chunksPerWorker * grain);
+                const size_t end = std::min(count, begin + chunksPerWorker * grain);
+                if (begin < end) {
+                    std::lock_guard<std::mutex> lock(queues_[i].mutex);
+                    queues_[i].ranges.push_back({ begin, end });
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(stateMutex_);
+                ++generation_;
+            }
+            const uint64_t started = metrics::enabled() ? metrics::nowNs() : 0;
+            wake_.notify_all();
+
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            done_.wait(lock, [&] { return remaining_.load(std::memory_order_acquire) == 0; });
+            if (started) {
+                // Whatever part of the batch a worker did not spend running chunks, it sat idle.
+                const uint64_t wall = metrics::nowNs() - started;
+                for (size_t i = 0; i < workers; ++i) {
+                    metrics::WorkerCounters& c = counters_->workers[i];
+                    const uint64_t busy = c.runBusyNs.exchange(0, std::memory_order_relaxed);
+                    c.idleNs.fetch_add(wall > busy ? wall - busy : 0, std::memory_order_relaxed);
+                }
+            }
+            if (error_) {
+                std::rethrow_exception(std::exchange(error_, nullptr));
+            }
+        }
+
+        // Take the next grain-sized chunk from the front of this worker's own deque.
+        bool popLocal(size_t index, Range& out) {
+            WorkerQueue& queue = queues_[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.ranges.empty()) {
+                return false;
+            }
+            Range& front = queue.ranges.front();
+            if (front.end - front.begin > grain_) {
+                out = { front.begin, front.begin + grain_ };
+                front.begin += grain_;
+            } else {
+                out = front;
+                queue.ranges.pop_front();
+            }
+            return true;
+        }
+
+        // Steal the back half (grain-aligned) of another worker's last range into our own deque.
+        bool steal(size_t thief) {
+            const size_t workers = threads_.size();
+            for (size_t offset = 1; offset < workers; ++offset) {
+                WorkerQueue& victim = queues_[(thief + offset) % workers];
+                Range stolen;
+                {
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (victim.ranges.empty()) {
+                        continue;
+                    }
+                    Range& back = victim.ranges.back();
+                    const size_t chunks = (back.end - back.begin + grain_ - 1) / grain_;
+                    if (chunks > 1) {
+                        const size_t mid = back.begin + (chunks / 2) * grain_;
+                        stolen = { mid, back.end };
+                        back.end = mid;
+                    } else {
+                        stolen = back;
+                        victim.ranges.pop_back();
+                    }
+                }
+                std::lock_guard<std::mutex> lock(queues_[thief].mutex);
+                queues_[thief].ranges.push_back(stolen);
+                return true;
+            }
+            return false;
+        }
+
+        void execute(size_t worker, const Range& range) {
+            const uint64_t started = metrics::enabled() ? metrics::nowNs() : 0;
+            try {
+                invoke_(context_, range.begin, range.end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(stateMutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+            const size_t items = range.end - range.begin;
+            if (started) {
+                const uint64_t busy = metrics::nowNs() - started;
+                metrics::WorkerCounters& c = counters_->workers[worker];
+                c.items.fetch_add(items, std::memory_order_relaxed);
+                c.chunks.fetch_add(1, std::memory_order_relaxed);
+                c.busyNs.fetch_add(busy, std::memory_order_relaxed);
+                c.runBusyNs.fetch_add(busy, std::memory_order_relaxed);
+            }
+            if (remaining_.fetch_sub(items, std::memory_order_acq_rel) == items) {
+                std::lock_guard<std::mutex> lock(stateMutex_);
+                done_.notify_all();
+            }
+        }
+
+        void workerLoop(size_t index) {
+            uint64_t seen = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(stateMutex_);
+                    wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                    if (stopping_) {
+                        return;
+                    }
+                    seen = generation_;
+                }
+                Range range;
+                while (true) {
+                    if (popLocal(index, range)) {
+                        execute(index, range);
+                    } else if (!steal(index)) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        std::vector<std::thread> threads_;
+        std::unique_ptr<WorkerQueue[]> queues_;
+        std::shared_ptr<metrics::WorkerGroup> counters_; // per-worker load, recorded when metrics are on
+
+        std::mutex submitMutex_;
+        std::mutex stateMutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        uint64_t generation_ = 0;
+        bool stopping_ = false;
+
+        // Current job; written under submitMutex_ before its ranges are published.
+        void* context_ = nullptr;
+        Invoker invoke_ = nullptr;
+        size_t grain_ = 1;
+        std::atomic<size_t> remaining_{0};
+        std::exception_ptr error_;
+    };
+
+} // namespace eth
+
+#endif // ETH_THREAD_POOL_H
@@ -0,0 +1,351 @@
+// watchlist.h - Matching derived addresses against a large set of watched addresses
+#ifndef ETH_WATCHLIST_H
+#define ETH_WATCHLIST_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "address.h"
+#include "address_batch.h"
+#include "thread_pool.h"
+
+namespace eth {
+
+    namespace watchlist_detail {
+
+        // Addresses hashed and prefetched together before any of them is tested.
+        inline constexpr size_t PREFETCH_GROUP = 16;
+
+        // Already-derived addresses handed to a worker at a time when only matching is left.
+        inline constexpr size_t MATCH_GRAIN = 1024;
+
+        // Salts of the split-block Bloom filter used by Parquet: one per 32-bit word of a block.
+        inline constexpr uint32_t BLOOM_SALTS[8] = { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                     0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+
+        // 256-bit filter block: a key sets one bit in each of the eight words.
+        struct alignas(32) BloomBlock {
+            uint32_t words[8];
+        };
+
+        // 64-bit hash of a 20-byte address. Both ends are mixed in because vanity
+        // addresses share long zero prefixes.
+        inline uint64_t hashAddress(const Byte* address) noexcept {
+            uint64_t head;
+            uint64_t tail;
+            std::memcpy(&head, address, 8);
+            std::memcpy(&tail, address + 12, 8);
+            uint64_t h = (head ^ std::rotl(tail, 29)) * 0x9E3779B97F4A7C15ULL;
+            h ^= h >> 32;
+            h *= 0xC2B2AE3D27D4EB4FULL;
+            return h ^ (h >> 29);
+        }
+
+        inline bool isZero(const Byte* address) noexcept {
+            static constexpr Byte zero[20] = {};
+            return std::memcmp(address, zero, 20) == 0;
+        }
+
+    } // namespace watchlist_detail
+
+    /**
+     * @brief Immutable set of watched addresses, built for testing millions of candidates.
+     *
+     * Lookups go through a split-block Bloom filter first: a candidate touches one 32-byte
+     * block and is rejected there unless all eight of its bits are set, so almost every
+     * non-member costs one hash and one cache miss. Survivors are confirmed in an
+     * open-addressed table of packed 20-byte addresses (linear probing, load factor at
+     * most 3/4; the all-zero address marks an empty slot and is tracked separately).
+     *
+     * matchBatch hashes a group of addresses and prefetches their filter blocks before
+     * testing any of them, then prefetches the table slots of the survivors, so the
+     * memory latency of a group overlaps instead of adding up.
+     */
+    class Watchlist {
+    public:
+        static constexpr size_t DEFAULT_BLOOM_BITS = 16;
+
+        // Empty watchlist: nothing matches.
+        Watchlist() : Watchlist(std::span<const Address>()) {}
+
+        /**
+         * @param addresses Watched addresses; duplicates are allowed.
+         * @param bloomBitsPerAddress Filter size per address; 16 rejects all but a few
+         *        tenths of a percent of non-members.
+         * @throws std::invalid_argument if bloomBitsPerAddress is zero.
+         */
+        explicit Watchlist(std::span<const Address> addresses, size_t bloomBitsPerAddress = DEFAULT_BLOOM_BITS) {
+            if (bloomBitsPerAddress == 0) {
+                throw std::invalid_argument("Watchlist Bloom filter needs at least one bit per address.");
+            }
+            const size_t n = addresses.size();
+            blocks_.assign(std::max<size_t>(1, (n * bloomBitsPerAddress + 255) / 256), watchlist_detail::BloomBlock{});
+            const size_t capacity = std::bit_ceil(std::max<size_t>(2, n + n / 3 + 1));
+            slots_.assign(capacity, Address{});
+            shift_ = 64 - static_cast<unsigned>(std::countr_zero(capacity));
+            for (const Address& address : addresses) {
+                insert(address);
+            }
+        }
+
+        /**
+         * @brief Build from packed 20-byte binary records.
+         * @throws std::invalid_argument if size is not a multiple of 20.
+         */
+        static Watchlist fromBinary(const Byte* data, size_t size, size_t bloomBitsPerAddress = DEFAULT_BLOOM_BITS) {
+            if (size % 20 != 0) {
+                throw std::invalid_argument("Watchlist binary data must be a whole number of 20-byte addresses.");
+            }
+            std::vector<Address> addresses(size / 20);
+            if (size > 0) {
+                std::memcpy(addresses.data(), data, size);
+            }
+            return Watchlist(addresses, bloomBitsPerAddress);
+        }
+
+        /**
+         * @brief Build from newline-separated hex addresses ("0x" optional, any letter case).
+         * @note Blank lines and trailing '\r' are ignored; checksums are not verified.
+         * @throws std::invalid_argument naming the first line that is not an address.
+         */
+        static Watchlist fromHexLines(std::string_view text, size_t bloomBitsPerAddress = DEFAULT_BLOOM_BITS) {
+            std::vector<Address> addresses;
+            addresses.reserve(text.size() / 41);
+            size_t lineNumber = 0;
+            while (!text.empty()) {
+                const size_t newline = text.find('\n');
+                std::string_view line = text.substr(0, newline);
+                text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+                ++lineNumber;
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1);
+                }
+                if (line.empty()) {
+                    continue;
+                }
+                if (!Address::parse(line, addresses.emplace_back())) {
+                    throw std::invalid_argument("Invalid watchlist address on line " + std::to_string(lineNumber) + ".");
+                }
+            }
+            return Watchlist(addresses, bloomBitsPerAddress);
+        }
+
+        // Number of distinct watched addresses.
+        size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        // Bytes held by the filter and the table.
+        size_t memoryBytes() const noexcept {
+            return blocks_.size() * sizeof(watchlist_detail::BloomBlock) + slots_.size() * sizeof(Address);
+        }
+
+        bool contains(const Byte* address) const noexcept {
+            const uint64_t h = watchlist_detail::hashAddress(address);
+            return mayContain(h) && confirm(h, address);
+        }
+
+        bool contains(const Address& address) const noexcept { return contains(address.data()); }
+
+        /**
+         * @brief Test many packed addresses.
+         * @param addresses `count` packed 20-byte addresses.
+         * @param count Number of addresses.
+         * @param matches Receives the indices of the watched addresses, ascending (room for `count`).
+         * @return Number of indices written.
+         */
+        size_t matchBatch(const Byte* addresses, size_t count, size_t* matches) const noexcept {
+            using namespace watchlist_detail;
+            uint64_t hashes[PREFETCH_GROUP];
+            size_t survivors[PREFETCH_GROUP];
+            size_t found = 0;
+            for (size_t base = 0; base < count; base += PREFETCH_GROUP) {
+                const size_t n = std::min(PREFETCH_GROUP, count - base);
+                const Byte* group = addresses + 20 * base;
+                for (size_t i = 0; i < n; ++i) {
+                    hashes[i] = hashAddress(group + 20 * i);
+                    __builtin_prefetch(&blocks_[blockOf(hashes[i])]);
+                }
+                size_t candidates = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    if (mayContain(hashes[i])) {
+                        __builtin_prefetch(&slots_[slotOf(hashes[i])]);
+                        survivors[candidates++] = i;
+                    }
+                }
+                for (size_t c = 0; c < candidates; ++c) {
+                    const size_t i = survivors[c];
+                    if (confirm(hashes[i], group + 20 * i)) {
+                        matches[found++] = base + i;
+                    }
+                }
+            }
+            return found;
+        }
+
+        /**
+         * @brief Test many addresses.
+         * @param matches Receives the indices of the watched addresses, ascending (room for addresses.size()).
+         * @return Number of indices written.
+         */
+        size_t matchBatch(std::span<const Address> addresses, size_t* matches) const noexcept {
+            return matchBatch(reinterpret_cast<const Byte*>(addresses.data()), addresses.size(), matches);
+        }
+
+    private:
+        size_t blockOf(uint64_t h) const noexcept {
+            return static_cast<size_t>(((h >> 32) * blocks_.size()) >> 32);
+        }
+
+        size_t slotOf(uint64_t h) const noexcept { return static_cast<size_t>(h >> shift_); }
+
+        bool mayContain(uint64_t h) const noexcept {
+            const watchlist_detail::BloomBlock& block = blocks_[blockOf(h)];
+            const uint32_t key = static_cast<uint32_t>(h);
+            uint32_t missing = 0;
+            for (size_t w = 0; w < 8; ++w) {
+                missing |= ~block.words[w] & (1u << ((key * watchlist_detail::BLOOM_SALTS[w]) >> 27));
+            }
+            return missing == 0;
+        }
+
+        bool confirm(uint64_t h, const Byte* address) const noexcept {
+            if (watchlist_detail::isZero(address)) {
+                return hasZero_;
+            }
+            const size_t mask = slots_.size() - 1;
+            for (size_t slot = slotOf(h);; slot = (slot + 1) & mask) {
+                const Byte* stored = slots_[slot].data();
+                if (std::memcmp(stored, address, 20) == 0) {
+                    return true;
+                }
+                if (watchlist_detail::isZero(stored)) {
+                    return false;
+                }
+            }
+        }
+
+        void insert(const Address& address) {
+            const uint64_t h = watchlist_detail::hashAddress(address.data());
+            if (confirm(h, address.data())) {
+                return;
+            }
+            watchlist_detail::BloomBlock& block = blocks_[blockOf(h)];
+            const uint32_t key = static_cast<uint32_t>(h);
+            for (size_t w = 0; w < 8; ++w) {
+                block.words[w] |= 1u << ((key * watchlist_detail::BLOOM_SALTS[w]) >> 27);
+            }
+            ++size_;
+            if (address.isZero()) {
+                hasZero_ = true;
+                return;
+            }
+            const size_t mask = slots_.size() - 1;
+            size_t slot = slotOf(h);
+            while (!slots_[slot].isZero()) {
+                slot = (slot + 1) & mask;
+            }
+            slots_[slot] = address;
+        }
+
+        std::vector<watchlist_detail::BloomBlock> blocks_;
+        std::vector<Address> slots_;
+        unsigned shift_ = 63;
+        size_t size_ = 0;
+        bool hasZero_ = false;
+    };
+
+    // A derived address found on a watchlist, with the index of the record it came from.
+    struct WatchlistMatch {
+        size_t index;
+        Address address;
+    };
+
+    /**
+     * @brief Derive addresses from public-key records and keep only those on a watchlist.
+     * @param records First record; record i starts at records + i * stride (key in the last 64 bytes).
+     * @param stride Bytes per record (at least 64).
+     * @param count Number of records.
+     * @param watchlist Addresses to look for.
+     * @param matches Matches are appended in record order.
+     * @param pool Pool whose workers run the derivation and the lookups.
+     * @return Number of matches appended.
+     * @throws std::invalid_argument if stride is less than 64.
+     * @note Each worker matches its addresses while they are still in cache; only matches
+     *       leave the worker, and no checksum hashes are computed.
+     */
+    inline size_t findWatchedAddresses(const Byte* records, size_t stride, size_t count, const Watchlist& watchlist,
+                                       std::vector<WatchlistMatch>& matches, ThreadPool& pool) {
+        if (stride < 64) {
+            throw std::invalid_argument("Public key record stride must be at least 64 bytes.");
+        }
+        const size_t first = matches.size();
+        std::mutex mutex;
+        pool.parallelFor(count, address_detail::GRAIN, [&](size_t begin, size_t end) {
+            // parallelFor never hands out more than GRAIN records at once.
+            Byte raw[address_detail::GRAIN * 20];
+            size_t hits[address_detail::GRAIN];
+            address_detail::deriveRange(records + begin * stride, stride, raw, 0, end - begin);
+            const size_t found = watchlist.matchBatch(raw, end - begin, hits);
+            if (found == 0) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < found; ++i) {
+                matches.push_back(WatchlistMatch{ begin + hits[i], Address::fromBytes(raw + 20 * hits[i]) });
+            }
+        });
+        std::sort(matches.begin() + static_cast<std::ptrdiff_t>(first), matches.end(),
+                  [](const WatchlistMatch& a, const WatchlistMatch& b) { return a.index < b.index; });
+        return matches.size() - first;
+    }
+
+    /**
+     * @brief findWatchedAddresses on the shared pool.
+     * @throws std::invalid_argument if stride is less than 64.
+     */
+    inline size_t findWatchedAddresses(const Byte* records, size_t stride, size_t count, const Watchlist& watchlist,
+                                       std::vector<WatchlistMatch>& matches) {
+        return findWatchedAddresses(records, stride, count, watchlist, matches, ThreadPool::shared());
+    }
+
+    /**
+     * @brief Keep the already-derived addresses that are on a watchlist.
+     * @param addresses Addresses to test; a match's index is its position here.
+     * @param watchlist Addresses to look for.
+     * @param matches Matches are appended in index order.
+     * @param pool Pool whose workers run matchBatch over chunks of the addresses.
+     * @return Number of matches appended.
+     */
+    inline size_t findWatchedAddresses(std::span<const Address> addresses, const Watchlist& watchlist,
+                                       std::vector<WatchlistMatch>& matches, ThreadPool& pool) {
+        const size_t first = matches.size();
+        std::mutex mutex;
+        pool.parallelFor(addresses.size(), watchlist_detail::MATCH_GRAIN, [&](size_t begin, size_t end) {
+            // parallelFor never hands out more than MATCH_GRAIN addresses at once.
+            size_t hits[watchlist_detail::MATCH_GRAIN];
+            const size_t found = watchlist.matchBatch(addresses.subspan(begin, end - begin), hits);
+            if (found == 0) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < found; ++i) {
+                matches.push_back(WatchlistMatch{ begin + hits[i], addresses[begin + hits[i]] });
+            }
+        });
+        std::sort(matches.begin() + static_cast<std::ptrdiff_t>(first), matches.end(),
+                  [](const WatchlistMatch& a, const WatchlistMatch& b) { return a.index < b.index; });
+        return matches.size() - first;
+    }
+
+} // namespace eth
+
+#endif // ETH_WATCHLIST_H
@@ -0,0 +1,52 @@
+// LUT_validation.h - keccak256 hash-string check using a 256-entry lookup table
+// o1 generated
+
+#ifndef HASH_VALIDATION_LUT_VALIDATION_H
+#define HASH_VALIDATION_LUT_VALIDATION_H
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace lut_validation {
+
+    // The table for 256 possible chars: 'true' = hex valid, 'false' = invalid.
+    // Built at compile time, indexed by unsigned char [0..255].
+    inline constexpr std::array<bool, 256> isHexTable = [] {
+        std::array<bool, 256> table{};
+        for (int i = 0; i < 256; ++i) {
+            // valid if 0..9 or (A..F) or (a..f)
+            bool digit   = (i >= '0' && i <= '9');
+            bool lowerAF = (i >= 'a' && i <= 'f');
+            bool upperAF = (i >= 'A' && i <= 'F');
+            table[i] = (digit || lowerAF || upperAF);
+        }
+        return table;
+    }();
+
+    inline bool isValidHexChar(char c) {
+        return isHexTable[static_cast<unsigned char>(c)];
+    }
+
+    inline bool isKeccak256(const std::string& input) {
+        std::string_view str = input;
+        // Strip prefix if present
+        if (str.size() >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+            str.remove_prefix(2);
+        }
+        // Must be exactly 64 hex digits
+        if (str.size() != 64) {
+            return false;
+        }
+        // Check each char in the table
+        for (char c : str) {
+            if (!isValidHexChar(c)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace lut_validation
+
+#endif // HASH_VALIDATION_LUT_VALIDATION_H
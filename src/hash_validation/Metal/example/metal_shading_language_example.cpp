@@ -1,6 +1,7 @@
 // o1 generated
 
 // PSEUDO-CODE METAL kernel (not standard C++)
+// CPU implementation of the same contract: hash_validation/batch_validation.h
 #include <metal_stdlib>
 using namespace metal;
 
@@ -0,0 +1,65 @@
+// Batch keccak256 hash-string validator (CPU replacement for the Metal example)
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include "batch_validation.h"
+
+// Bytes reserved per candidate: room for "0x" + 64 digits, rounded up.
+constexpr size_t STRIDE = 72;
+
+int main(int argc, char* argv[]) {
+    // Read newline-delimited candidates from a file, or stdin when no file is given.
+    std::ifstream file;
+    bool printValid = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--valid") == 0) {
+            printValid = true;
+        } else {
+            file.open(argv[i], std::ios::binary);
+            if (!file) {
+                std::cerr << "Error: cannot open " << argv[i] << '\n';
+                return 1;
+            }
+        }
+    }
+    std::istream& in = file.is_open() ? static_cast<std::istream&>(file) : std::cin;
+
+    // Pack candidates into a strided, NUL-padded buffer. Lines longer than the
+    // stride are truncated; they stay invalid because no terminator follows the digits.
+    std::vector<char> packed;
+    std::string line;
+    size_t count = 0;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        packed.resize((count + 1) * STRIDE, '\0');
+        std::memcpy(packed.data() + count * STRIDE, line.data(), std::min(line.size(), STRIDE));
+        ++count;
+    }
+
+    std::vector<uint64_t> results((count + 63) / 64);
+    auto start = std::chrono::steady_clock::now();
+    hash_validation::validateHexStrings(packed.data(), count, STRIDE, results.data());
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t valid = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if ((results[i / 64] >> (i % 64)) & 1) {
+            ++valid;
+            if (printValid) {
+                std::cout.write(packed.data() + i * STRIDE, strnlen(packed.data() + i * STRIDE, STRIDE)) << '\n';
+            }
+        }
+    }
+    std::cerr << valid << " of " << count << " candidates are valid keccak256 hashes";
+    if (elapsed > 0) {
+        std::cerr << " (" << static_cast<size_t>(count / elapsed) << " strings/s)";
+    }
+    std::cerr << '\n';
+    return 0;
+}
@@ -0,0 +1,186 @@
+// batch_validation.h - CPU batch keccak256 hash-string validator
+//
+// Same contract as the Metal validateHexStrings sketch: a packed buffer of
+// candidate strings, a per-string stride, a count and one result bit per
+// string. Each record holds 64 hex digits, optionally prefixed with
+// "0x"/"0X", and is either exactly stride bytes long or NUL-terminated
+// within its stride.
+
+#ifndef HASH_VALIDATION_BATCH_VALIDATION_H
+#define HASH_VALIDATION_BATCH_VALIDATION_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+
+#include "../cpu/cpu_dispatch.h"
+#include "../eth/thread_pool.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HASH_VALIDATION_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define HASH_VALIDATION_HAVE_X86_SIMD 0
+#endif
+
+namespace hash_validation {
+
+    namespace detail {
+
+        // The table for 256 possible chars: 'true' = hex valid, 'false' = invalid.
+        inline constexpr std::array<bool, 256> IS_HEX = []() constexpr {
+            std::array<bool, 256> table{};
+            for (int c = '0'; c <= '9'; ++c) table[c] = true;
+            for (int c = 'a'; c <= 'f'; ++c) table[c] = true;
+            for (int c = 'A'; c <= 'F'; ++c) table[c] = true;
+            return table;
+        }();
+
+        // Offset of the 64 hex digits inside a record, or -1 if the record cannot hold them.
+        inline int digitsOffset(const char* record, size_t stride) noexcept {
+            const bool prefixed = stride >= 2 && record[0] == '0' && (record[1] == 'x' || record[1] == 'X');
+            const size_t start = prefixed ? 2 : 0;
+            if (stride < start + 64) {
+                return -1;
+            }
+            // The digits must end the string: either the record is full, or a NUL follows.
+            if (stride > start + 64 && record[start + 64] != '\0') {
+                return -1;
+            }
+            return static_cast<int>(start);
+        }
+
+        inline bool isKeccak256Scalar(const char* record, size_t stride) noexcept {
+            const int start = digitsOffset(record, stride);
+            if (start < 0) {
+                return false;
+            }
+            bool valid = true;
+            for (size_t i = 0; i < 64; ++i) {
+                valid &= IS_HEX[static_cast<unsigned char>(record[start + i])];
+            }
+            return valid;
+        }
+
+#if HASH_VALIDATION_HAVE_X86_SIMD
+        // Signed-compare range check: c is a hex digit iff (c - '0') or ((c | 0x20) - 'a'),
+        // biased into the bottom of the signed byte range, falls below 10 or 6 respectively.
+        __attribute__((target("avx2")))
+        inline bool isKeccak256AVX2(const char* record, size_t stride) noexcept {
+            const int start = digitsOffset(record, stride);
+            if (start < 0) {
+                return false;
+            }
+            const __m256i digitBias = _mm256_set1_epi8(static_cast<char>(0x80 - '0'));
+            const __m256i alphaBias = _mm256_set1_epi8(static_cast<char>(0x80 - 'a'));
+            const __m256i digitLimit = _mm256_set1_epi8(static_cast<char>(-128 + 10));
+            const __m256i alphaLimit = _mm256_set1_epi8(static_cast<char>(-128 + 6));
+            const __m256i caseBit = _mm256_set1_epi8(0x20);
+            __m256i valid = _mm256_set1_epi8(-1);
+            for (int i = 0; i < 64; i += 32) {
+                const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(record + start + i));
+                const __m256i isDigit = _mm256_cmpgt_epi8(digitLimit, _mm256_add_epi8(c, digitBias));
+                const __m256i isAlpha = _mm256_cmpgt_epi8(alphaLimit,
+                                                          _mm256_add_epi8(_mm256_or_si256(c, caseBit), alphaBias));
+                valid = _mm256_and_si256(valid, _mm256_or_si256(isDigit, isAlpha));
+            }
+            return static_cast<uint32_t>(_mm256_movemask_epi8(valid)) == 0xFFFFFFFFu;
+        }
+
+        // One 64-byte load covers all digits; unsigned compares produce the validity mask directly.
+        __attribute__((target("avx512f,avx512bw")))
+        inline bool isKeccak256AVX512(const char* record, size_t stride) noexcept {
+            const int start = digitsOffset(record, stride);
+            if (start < 0) {
+                return false;
+            }
+            const __m512i c = _mm512_loadu_si512(record + start);
+            const __mmask64 isDigit = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(c, _mm512_set1_epi8('0')),
+                                                             _mm512_set1_epi8(10));
+            const __mmask64 isAlpha = _mm512_cmplt_epu8_mask(
+                _mm512_sub_epi8(_mm512_or_si512(c, _mm512_set1_epi8(0x20)), _mm512_set1_epi8('a')),
+                _mm512_set1_epi8(6));
+            return (isDigit | isAlpha) == ~__mmask64(0);
+        }
+#endif // HASH_VALIDATION_HAVE_X86_SIMD
+
+        using RecordValidator = bool (*)(const char*, size_t) noexcept;
+
+        // Pick the widest validator the running CPU (and KECCAK_CPU_LEVEL) allows, once.
+        inline RecordValidator recordValidator() noexcept {
+            static const RecordValidator validator = []() -> RecordValidator {
+#if HASH_VALIDATION_HAVE_X86_SIMD
+                if (cpu::supports(cpu::Feature::AVX512F) && cpu::supports(cpu::Feature::AVX512BW)) {
+                    cpu::recordSelection("hash_validation", "avx512bw");
+                    return &isKeccak256AVX512;
+                }
+                if (cpu::supports(cpu::Feature::AVX2)) {
+                    cpu::recordSelection("hash_validation", "avx2");
+                    return &isKeccak256AVX2;
+                }
+#endif
+                cpu::recordSelection("hash_validation", "scalar");
+                return &isKeccak256Scalar;
+            }();
+            return validator;
+        }
+
+        // Bind the validator during static initialization, before main.
+        inline const RecordValidator boundValidator = recordValidator();
+
+        // Validate records [begin, end), writing whole result words; begin must be a multiple of 64.
+        inline void validateRange(RecordValidator validator, const char* stringData, size_t stride,
+                                  size_t begin, size_t end, uint64_t* results) noexcept {
+            for (size_t wordStart = begin; wordStart < end; wordStart += 64) {
+                const size_t wordEnd = std::min(wordStart + 64, end);
+                uint64_t word = 0;
+                for (size_t i = wordStart; i < wordEnd; ++i) {
+                    word |= uint64_t(validator(stringData + i * stride, stride)) << (i - wordStart);
+                }
+                results[wordStart / 64] = word;
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Check that a single record holds a keccak256 hash string.
+     * @param record Start of the record.
+     * @param stride Bytes available in the record.
+     * @return true for 64 hex digits, optionally "0x"-prefixed, ending at the stride or a NUL.
+     */
+    inline bool isKeccak256Record(const char* record, size_t stride) noexcept {
+        return detail::recordValidator()(record, stride);
+    }
+
+    /**
+     * @brief Validate many packed candidate hash strings in parallel.
+     * @param stringData Buffer containing all records back-to-back.
+     * @param numStrings Number of records.
+     * @param stridePerString Bytes per record.
+     * @param results Output bitmap of (numStrings + 63) / 64 words; bit i is set if record i is valid.
+     * @param pool Pool whose workers run the validation. Small inputs run inline.
+     * @note Uses AVX-512BW (one 64-byte compare per record) or AVX2 where available. Work is handed
+     *       out in grains of 64 result words, so every worker owns whole result words.
+     */
+    inline void validateHexStrings(const char* stringData, size_t numStrings, size_t stridePerString,
+                                   uint64_t* results, eth::ThreadPool& pool) {
+        const detail::RecordValidator validator = detail::recordValidator();
+        constexpr size_t grain = 64 * 64; // records; a multiple of 64 keeps result words unshared
+        pool.parallelFor(numStrings, grain, [&](size_t begin, size_t end) {
+            detail::validateRange(validator, stringData, stridePerString, begin, end, results);
+        });
+    }
+
+    /**
+     * @brief Validate many packed candidate hash strings in parallel on the shared pool.
+     */
+    inline void validateHexStrings(const char* stringData, size_t numStrings, size_t stridePerString,
+                                   uint64_t* results) {
+        validateHexStrings(stringData, numStrings, stridePerString, results, eth::ThreadPool::shared());
+    }
+
+} // namespace hash_validation
+
+#endif // HASH_VALIDATION_BATCH_VALIDATION_H
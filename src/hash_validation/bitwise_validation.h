@@ -0,0 +1,52 @@
+// bitwise_validation.h - keccak256 hash-string check using a case-folding bit trick
+// o1 generated
+
+#ifndef HASH_VALIDATION_BITWISE_VALIDATION_H
+#define HASH_VALIDATION_BITWISE_VALIDATION_H
+
+#include <string>
+#include <string_view>
+
+namespace bitwise_validation {
+
+    // Bitwise-based hex check.
+    // Explanation:
+    //   1) If '0' <= c <= '9', it's valid.
+    //   2) Otherwise, convert c to uppercase by clearing bit 5 (c & ~0x20).
+    //      Then check if 'A' <= (converted c) <= 'F'.
+    inline bool isValidHexChar(char c) {
+        // Check numeric range.
+        if (c >= '0' && c <= '9') {
+            return true;
+        }
+        // Force uppercase by clearing bit 5 (0x20).
+        unsigned char upperC = static_cast<unsigned char>(c) & static_cast<unsigned char>(~0x20);
+        return (upperC >= 'A' && upperC <= 'F');
+    }
+
+    inline bool isKeccak256(const std::string& input) {
+        // View the input so the optional "0x"/"0X" prefix can be skipped without copying.
+        std::string_view str = input;
+
+        // If input starts with "0x" or "0X", remove the prefix.
+        if (str.size() >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+            str.remove_prefix(2);
+        }
+
+        // A valid keccak256 hash must have exactly 64 hex characters.
+        if (str.size() != 64) {
+            return false;
+        }
+
+        // Check each character via bitwise function.
+        for (char c : str) {
+            if (!isValidHexChar(c)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace bitwise_validation
+
+#endif // HASH_VALIDATION_BITWISE_VALIDATION_H
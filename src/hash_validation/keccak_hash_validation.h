@@ -0,0 +1,38 @@
+// keccak_hash_validation.h - Straightforward keccak256 hash-string check (range comparisons)
+
+#ifndef HASH_VALIDATION_KECCAK_HASH_VALIDATION_H
+#define HASH_VALIDATION_KECCAK_HASH_VALIDATION_H
+
+#include <string>
+#include <string_view>
+
+namespace naive_validation {
+
+    // Helper function to check if a character is a valid hex digit.
+    inline bool isValidHexChar(char c) {
+        return (c >= '0' && c <= '9') ||
+               (c >= 'a' && c <= 'f') ||
+               (c >= 'A' && c <= 'F');
+    }
+
+    // Function that checks if the given string is a valid keccak256 hash.
+    inline bool isKeccak256(const std::string& hexStr) {
+        std::string_view str = hexStr;
+        // If the string starts with "0x" or "0X", remove the prefix.
+        if (str.size() >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+            str.remove_prefix(2);
+        }
+        // A valid keccak256 hash must have exactly 64 hexadecimal characters.
+        if (str.length() != 64)
+            return false;
+        // Check each character to ensure it is a valid hexadecimal digit.
+        for (char c : str) {
+            if (!isValidHexChar(c))
+                return false;
+        }
+        return true;
+    }
+
+} // namespace naive_validation
+
+#endif // HASH_VALIDATION_KECCAK_HASH_VALIDATION_H
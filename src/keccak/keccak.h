@@ -0,0 +1,383 @@
+// keccak.h - Core Keccak definitions and an in-tree Keccak-f[1600] engine
+#ifndef KECCAK_H
+#define KECCAK_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <algorithm>
+#include <bit>
+
+// Keccak-f[1600] state size in bytes (200 bytes = 1600 bits)
+inline constexpr size_t KECCAK_STATE_SIZE = 200;
+
+// Rate of Keccak-256 / SHA3-256 in bytes (1600 - 2 * 256 bits)
+inline constexpr size_t KECCAK256_RATE = 136;
+
+// Round constants for Keccak-f permutation
+inline constexpr std::array<uint64_t, 24> KECCAK_ROUND_CONSTANTS = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// Rotation offsets for Keccak-f permutation (indexed by x + 5 * y)
+inline constexpr std::array<int, 25> KECCAK_ROTATION_OFFSETS = {
+    0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43,
+    25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14
+};
+
+namespace keccak_detail {
+
+    // Load a little-endian 64-bit lane from an unaligned byte pointer.
+    inline uint64_t loadLane(const uint8_t* p) noexcept {
+        uint64_t lane;
+        std::memcpy(&lane, p, sizeof(lane));
+        if constexpr (std::endian::native == std::endian::big) {
+            lane = __builtin_bswap64(lane);
+        }
+        return lane;
+    }
+
+    // Store a 64-bit lane as little-endian bytes to an unaligned byte pointer.
+    inline void storeLane(uint8_t* p, uint64_t lane) noexcept {
+        if constexpr (std::endian::native == std::endian::big) {
+            lane = __builtin_bswap64(lane);
+        }
+        std::memcpy(p, &lane, sizeof(lane));
+    }
+
+    /**
+     * @brief Apply Keccak-f[1600] to 25 lanes using fully unrolled rounds.
+     * @param lanes The state, lane (x, y) at index x + 5 * y.
+     * @note The whole state lives in local variables for the 24 rounds, so
+     *       the compiler keeps it in registers (spilling only what it must).
+     *       Lanes 1, 2, 8, 12, 17 and 20 are complemented on entry and exit
+     *       (the "bebigokimisa" pattern), which lets chi use one NOT per row
+     *       instead of five since most ANDN terms become plain AND/OR.
+     */
+    inline void keccakF1600(uint64_t* lanes) noexcept {
+        uint64_t Aba = lanes[0],  Abe = ~lanes[1],  Abi = ~lanes[2],  Abo = lanes[3],   Abu = lanes[4];
+        uint64_t Aga = lanes[5],  Age = lanes[6],   Agi = lanes[7],   Ago = ~lanes[8],  Agu = lanes[9];
+        uint64_t Aka = lanes[10], Ake = lanes[11],  Aki = ~lanes[12], Ako = lanes[13],  Aku = lanes[14];
+        uint64_t Ama = lanes[15], Ame = lanes[16],  Ami = ~lanes[17], Amo = lanes[18],  Amu = lanes[19];
+        uint64_t Asa = ~lanes[20], Ase = lanes[21], Asi = lanes[22],  Aso = lanes[23],  Asu = lanes[24];
+
+        uint64_t Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu;
+        uint64_t Eka, Eke, Eki, Eko, Eku, Ema, Eme, Emi, Emo, Emu;
+        uint64_t Esa, Ese, Esi, Eso, Esu;
+        uint64_t Bba, Bbe, Bbi, Bbo, Bbu, Bga, Bge, Bgi, Bgo, Bgu;
+        uint64_t Bka, Bke, Bki, Bko, Bku, Bma, Bme, Bmi, Bmo, Bmu;
+        uint64_t Bsa, Bse, Bsi, Bso, Bsu;
+        uint64_t Da, De, Di, Do, Du;
+
+        uint64_t Ca = Aba ^ Aga ^ Aka ^ Ama ^ Asa;
+        uint64_t Ce = Abe ^ Age ^ Ake ^ Ame ^ Ase;
+        uint64_t Ci = Abi ^ Agi ^ Aki ^ Ami ^ Asi;
+        uint64_t Co = Abo ^ Ago ^ Ako ^ Amo ^ Aso;
+        uint64_t Cu = Abu ^ Agu ^ Aku ^ Amu ^ Asu;
+
+        // One round reading state A and writing state E, with theta, rho, pi,
+        // chi (lane-complemented form) and iota merged, and the column
+        // parities for the next round accumulated as the rows are produced.
+#define KECCAK_ROUND(i, A, E) \
+        Da = Cu ^ std::rotl(Ce, 1); \
+        De = Ca ^ std::rotl(Ci, 1); \
+        Di = Ce ^ std::rotl(Co, 1); \
+        Do = Ci ^ std::rotl(Cu, 1); \
+        Du = Co ^ std::rotl(Ca, 1); \
+        \
+        Bba = A##ba ^ Da; \
+        Bbe = std::rotl(A##ge ^ De, 44); \
+        Bbi = std::rotl(A##ki ^ Di, 43); \
+        Bbo = std::rotl(A##mo ^ Do, 21); \
+        Bbu = std::rotl(A##su ^ Du, 14); \
+        E##ba = Bba ^ (Bbe | Bbi) ^ KECCAK_ROUND_CONSTANTS[i]; Ca = E##ba; \
+        E##be = Bbe ^ ((~Bbi) | Bbo); Ce = E##be; \
+        E##bi = Bbi ^ (Bbo & Bbu);    Ci = E##bi; \
+        E##bo = Bbo ^ (Bbu | Bba);    Co = E##bo; \
+        E##bu = Bbu ^ (Bba & Bbe);    Cu = E##bu; \
+        \
+        Bga = std::rotl(A##bo ^ Do, 28); \
+        Bge = std::rotl(A##gu ^ Du, 20); \
+        Bgi = std::rotl(A##ka ^ Da, 3); \
+        Bgo = std::rotl(A##me ^ De, 45); \
+        Bgu = std::rotl(A##si ^ Di, 61); \
+        E##ga = Bga ^ (Bge | Bgi);    Ca ^= E##ga; \
+        E##ge = Bge ^ (Bgi & Bgo);    Ce ^= E##ge; \
+        E##gi = Bgi ^ (Bgo | (~Bgu)); Ci ^= E##gi; \
+        E##go = Bgo ^ (Bgu | Bga);    Co ^= E##go; \
+        E##gu = Bgu ^ (Bga & Bge);    Cu ^= E##gu; \
+        \
+        Bka = std::rotl(A##be ^ De, 1); \
+        Bke = std::rotl(A##gi ^ Di, 6); \
+        Bki = std::rotl(A##ko ^ Do, 25); \
+        Bko = std::rotl(A##mu ^ Du, 8); \
+        Bku = std::rotl(A##sa ^ Da, 18); \
+        E##ka = Bka ^ (Bke | Bki);     Ca ^= E##ka; \
+        E##ke = Bke ^ (Bki & Bko);     Ce ^= E##ke; \
+        E##ki = Bki ^ ((~Bko) & Bku);  Ci ^= E##ki; \
+        E##ko = (~Bko) ^ (Bku | Bka);  Co ^= E##ko; \
+        E##ku = Bku ^ (Bka & Bke);     Cu ^= E##ku; \
+        \
+        Bma = std::rotl(A##bu ^ Du, 27); \
+        Bme = std::rotl(A##ga ^ Da, 36); \
+        Bmi = std::rotl(A##ke ^ De, 10); \
+        Bmo = std::rotl(A##mi ^ Di, 15); \
+        Bmu = std::rotl(A##so ^ Do, 56); \
+        E##ma = Bma ^ (Bme & Bmi);     Ca ^= E##ma; \
+        E##me = Bme ^ (Bmi | Bmo);     Ce ^= E##me; \
+        E##mi = Bmi ^ ((~Bmo) | Bmu);  Ci ^= E##mi; \
+        E##mo = (~Bmo) ^ (Bmu & Bma);  Co ^= E##mo; \
+        E##mu = Bmu ^ (Bma | Bme);     Cu ^= E##mu; \
+        \
+        Bsa = std::rotl(A##bi ^ Di, 62); \
+        Bse = std::rotl(A##go ^ Do, 55); \
+        Bsi = std::rotl(A##ku ^ Du, 39); \
+        Bso = std::rotl(A##ma ^ Da, 41); \
+        Bsu = std::rotl(A##se ^ De, 2); \
+        E##sa = Bsa ^ ((~Bse) & Bsi);  Ca ^= E##sa; \
+        E##se = (~Bse) ^ (Bsi | Bso);  Ce ^= E##se; \
+        E##si = Bsi ^ (Bso & Bsu);     Ci ^= E##si; \
+        E##so = Bso ^ (Bsu | Bsa);     Co ^= E##so; \
+        E##su = Bsu ^ (Bsa & Bse);     Cu ^= E##su;
+
+        KECCAK_ROUND(0, A, E)  KECCAK_ROUND(1, E, A)
+        KECCAK_ROUND(2, A, E)  KECCAK_ROUND(3, E, A)
+        KECCAK_ROUND(4, A, E)  KECCAK_ROUND(5, E, A)
+        KECCAK_ROUND(6, A, E)  KECCAK_ROUND(7, E, A)
+        KECCAK_ROUND(8, A, E)  KECCAK_ROUND(9, E, A)
+        KECCAK_ROUND(10, A, E) KECCAK_ROUND(11, E, A)
+        KECCAK_ROUND(12, A, E) KECCAK_ROUND(13, E, A)
+        KECCAK_ROUND(14, A, E) KECCAK_ROUND(15, E, A)
+        KECCAK_ROUND(16, A, E) KECCAK_ROUND(17, E, A)
+        KECCAK_ROUND(18, A, E) KECCAK_ROUND(19, E, A)
+        KECCAK_ROUND(20, A, E) KECCAK_ROUND(21, E, A)
+        KECCAK_ROUND(22, A, E) KECCAK_ROUND(23, E, A)
+#undef KECCAK_ROUND
+
+        (void)Ca; (void)Ce; (void)Ci; (void)Co; (void)Cu;
+
+        lanes[0]  = Aba;  lanes[1]  = ~Abe; lanes[2]  = ~Abi; lanes[3]  = Abo;  lanes[4]  = Abu;
+        lanes[5]  = Aga;  lanes[6]  = Age;  lanes[7]  = Agi;  lanes[8]  = ~Ago; lanes[9]  = Agu;
+        lanes[10] = Aka;  lanes[11] = Ake;  lanes[12] = ~Aki; lanes[13] = Ako;  lanes[14] = Aku;
+        lanes[15] = Ama;  lanes[16] = Ame;  lanes[17] = ~Ami; lanes[18] = Amo;  lanes[19] = Amu;
+        lanes[20] = ~Asa; lanes[21] = Ase;  lanes[22] = Asi;  lanes[23] = Aso;  lanes[24] = Asu;
+    }
+
+} // namespace keccak_detail
+
+/**
+ * @brief Keccak-f[1600] sponge state.
+ *
+ * Bytes are absorbed and squeezed in little-endian lane order, so the state
+ * is byte-for-byte compatible with the reference implementation and Crypto++.
+ * The sponge position is tracked internally, so absorb() and squeeze() may be
+ * called repeatedly with arbitrary chunk sizes.
+ */
+class KeccakState {
+private:
+    // State as 5x5 array of 64-bit words
+    std::array<uint64_t, 25> state;
+    // Byte offset of the next absorb/squeeze within the current rate block
+    size_t position;
+
+public:
+    KeccakState() noexcept { reset(); }
+
+    // Reset state to all zeros
+    void reset() noexcept {
+        state.fill(0);
+        position = 0;
+    }
+
+    // Apply Keccak-f[1600] permutation
+    void permute() noexcept { keccak_detail::keccakF1600(state.data()); }
+
+    /**
+     * @brief Absorb data into the state, permuting after every full rate block.
+     * @param data Input bytes.
+     * @param length Number of input bytes.
+     * @param rate Sponge rate in bytes (a multiple of 8, at most 200).
+     */
+    void absorb(const uint8_t* data, size_t length, size_t rate) noexcept {
+        if (position != 0) {
+            const size_t take = std::min(length, rate - position);
+            xorIntoState(data, take, position);
+            data += take;
+            length -= take;
+            position += take;
+            if (position < rate) {
+                return;
+            }
+            permute();
+            position = 0;
+        }
+        const size_t rateLanes = rate / 8;
+        while (length >= rate) {
+            for (size_t i = 0; i < rateLanes; ++i) {
+                state[i] ^= keccak_detail::loadLane(data + 8 * i);
+            }
+            permute();
+            data += rate;
+            length -= rate;
+        }
+        if (length != 0) {
+            xorIntoState(data, length, 0);
+            position = length;
+        }
+    }
+
+    /**
+     * @brief Apply multi-rate padding and the final permutation of the absorb phase.
+     * @param delimiter Domain separation byte: 0x01 for Keccak, 0x06 for SHA3, 0x1F for SHAKE.
+     * @param rate Sponge rate in bytes.
+     * @note After this call the state is positioned at the first output byte.
+     */
+    void finalize(uint8_t delimiter, size_t rate) noexcept {
+        state[position / 8] ^= uint64_t(delimiter) << (8 * (position % 8));
+        state[(rate - 1) / 8] ^= uint64_t(0x80) << (8 * ((rate - 1) % 8));
+        permute();
+        position = 0;
+    }
+
+    /**
+     * @brief Squeeze output from the state, permuting whenever a rate block is exhausted.
+     * @param output Destination buffer.
+     * @param length Number of bytes to produce.
+     * @param rate Sponge rate in bytes.
+     * @note Must only be called after finalize().
+     */
+    void squeeze(uint8_t* output, size_t length, size_t rate) noexcept {
+        while (length != 0) {
+            if (position == rate) {
+                permute();
+                position = 0;
+            }
+            const size_t take = std::min(length, rate - position);
+            extractBytes(output, take, position);
+            output += take;
+            length -= take;
+            position += take;
+        }
+    }
+
+    // XOR data into state at specified offset
+    void xorIntoState(const uint8_t* data, size_t length, size_t offset) noexcept {
+        for (size_t i = 0; i < length; ++i) {
+            const size_t byteIndex = offset + i;
+            state[byteIndex / 8] ^= uint64_t(data[i]) << (8 * (byteIndex % 8));
+        }
+    }
+
+    // Extract bytes from state
+    void extractBytes(uint8_t* output, size_t length, size_t offset) const noexcept {
+        if (offset % 8 == 0 && length % 8 == 0) {
+            for (size_t i = 0; i < length / 8; ++i) {
+                keccak_detail::storeLane(output + 8 * i, state[offset / 8 + i]);
+            }
+            return;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            const size_t byteIndex = offset + i;
+            output[i] = static_cast<uint8_t>(state[byteIndex / 8] >> (8 * (byteIndex % 8)));
+        }
+    }
+};
+
+/**
+ * @brief Header-only Keccak-256 (original Ethereum padding) hasher.
+ *
+ * Mirrors the Restart/Update/Final shape of CryptoPP::Keccak_256 so it can be
+ * swapped in directly, but with no virtual dispatch and no heap state.
+ */
+class Keccak256 {
+public:
+    static constexpr size_t DIGESTSIZE = 32;
+    static constexpr size_t BLOCKSIZE = KECCAK256_RATE;
+
+    Keccak256() noexcept = default;
+
+    // Discard any absorbed input and start a new hash.
+    void Restart() noexcept { state_.reset(); }
+
+    // Absorb a chunk of input.
+    void Update(const uint8_t* data, size_t length) noexcept {
+        state_.absorb(data, length, BLOCKSIZE);
+    }
+
+    // Write the 32-byte digest and restart for the next message.
+    void Final(uint8_t* digest) noexcept {
+        state_.finalize(0x01, BLOCKSIZE);
+        state_.extractBytes(digest, DIGESTSIZE, 0);
+        state_.reset();
+    }
+
+    // One-shot hash of a complete message.
+    void CalculateDigest(uint8_t* digest, const uint8_t* data, size_t length) noexcept {
+        Restart();
+        Update(data, length);
+        Final(digest);
+    }
+
+private:
+    KeccakState state_;
+};
+
+/**
+ * @brief One-shot Keccak-256 of a complete message.
+ * @param data Input bytes.
+ * @param length Number of input bytes.
+ * @param digest Output buffer of at least 32 bytes.
+ */
+inline void keccak256(const uint8_t* data, size_t length, uint8_t* digest) noexcept {
+    Keccak256 keccak;
+    keccak.Update(data, length);
+    keccak.Final(digest);
+}
+
+/**
+ * @brief One-shot Keccak-256 of a message whose length is fixed at compile time and fits one rate block.
+ *
+ * The input is loaded straight into the state lanes, the padding is applied
+ * as two constant XORs and exactly one permutation is run; there is no
+ * streaming buffer or length bookkeeping.
+ *
+ * @tparam Length Message length in bytes (at most 135, so the padding fits the block).
+ * @param data Input bytes.
+ * @param digest Output buffer of at least 32 bytes.
+ */
+template <size_t Length>
+inline void keccak256Fixed(const uint8_t* data, uint8_t* digest) noexcept {
+    static_assert(Length < KECCAK256_RATE, "keccak256Fixed requires a single-block message (at most 135 bytes)");
+    constexpr size_t fullLanes = Length / 8;
+    constexpr size_t tailBytes = Length % 8;
+
+    uint64_t lanes[25] = {};
+    for (size_t i = 0; i < fullLanes; ++i) {
+        lanes[i] = keccak_detail::loadLane(data + 8 * i);
+    }
+    if constexpr (tailBytes != 0) {
+        uint64_t tail = 0;
+        for (size_t j = 0; j < tailBytes; ++j) {
+            tail |= uint64_t(data[8 * fullLanes + j]) << (8 * j);
+        }
+        lanes[fullLanes] = tail;
+    }
+    lanes[fullLanes] ^= uint64_t(0x01) << (8 * tailBytes);
+    lanes[KECCAK256_RATE / 8 - 1] ^= uint64_t(0x80) << 56;
+
+    keccak_detail::keccakF1600(lanes);
+
+    for (size_t i = 0; i < 4; ++i) {
+        keccak_detail::storeLane(digest + 8 * i, lanes[i]);
+    }
+}
+
+#endif // KECCAK_H
@@ -0,0 +1,83 @@
+// keccak_constexpr.h - Compile-time Keccak-256 for constant inputs such as ABI signatures
+#ifndef KECCAK_CONSTEXPR_H
+#define KECCAK_CONSTEXPR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <bit>
+#include <string_view>
+
+#include "keccak.h"
+
+namespace keccak_detail {
+
+    /**
+     * @brief Keccak-f[1600] written for constant evaluation.
+     * @param lanes The state, lane (x, y) at index x + 5 * y.
+     * @note A plain loop over the shared KECCAK_ROUND_CONSTANTS and KECCAK_ROTATION_OFFSETS
+     *       tables; it is only meant for the compiler; runtime code uses keccakF1600().
+     */
+    constexpr void keccakF1600Constexpr(std::array<uint64_t, 25>& lanes) noexcept {
+        for (uint64_t roundConstant : KECCAK_ROUND_CONSTANTS) {
+            // Theta
+            uint64_t c[5] = {};
+            for (size_t x = 0; x < 5; ++x) {
+                c[x] = lanes[x] ^ lanes[x + 5] ^ lanes[x + 10] ^ lanes[x + 15] ^ lanes[x + 20];
+            }
+            for (size_t x = 0; x < 5; ++x) {
+                const uint64_t d = c[(x + 4) % 5] ^ std::rotl(c[(x + 1) % 5], 1);
+                for (size_t y = 0; y < 25; y += 5) {
+                    lanes[x + y] ^= d;
+                }
+            }
+            // Rho and pi: lane (x, y) moves to (y, 2x + 3y).
+            std::array<uint64_t, 25> b{};
+            for (size_t x = 0; x < 5; ++x) {
+                for (size_t y = 0; y < 5; ++y) {
+                    b[y + 5 * ((2 * x + 3 * y) % 5)] =
+                        std::rotl(lanes[x + 5 * y], KECCAK_ROTATION_OFFSETS[x + 5 * y]);
+                }
+            }
+            // Chi
+            for (size_t y = 0; y < 25; y += 5) {
+                for (size_t x = 0; x < 5; ++x) {
+                    lanes[x + y] = b[x + y] ^ (~b[(x + 1) % 5 + y] & b[(x + 2) % 5 + y]);
+                }
+            }
+            // Iota
+            lanes[0] ^= roundConstant;
+        }
+    }
+
+} // namespace keccak_detail
+
+/**
+ * @brief Keccak-256 (original Ethereum padding) usable in constant expressions.
+ * @param message Input bytes; any length.
+ * @return The 32-byte digest.
+ * @note Produces the same digest as keccak256(); at run time prefer that function.
+ */
+constexpr std::array<uint8_t, 32> keccak256Constexpr(std::string_view message) noexcept {
+    std::array<uint64_t, 25> lanes{};
+    size_t offset = 0;
+    // Absorb byte by byte; the final partial block (possibly empty) is padded below.
+    for (char c : message) {
+        lanes[offset / 8] ^= uint64_t(static_cast<uint8_t>(c)) << (8 * (offset % 8));
+        if (++offset == KECCAK256_RATE) {
+            keccak_detail::keccakF1600Constexpr(lanes);
+            offset = 0;
+        }
+    }
+    lanes[offset / 8] ^= uint64_t(0x01) << (8 * (offset % 8));
+    lanes[KECCAK256_RATE / 8 - 1] ^= uint64_t(0x80) << 56;
+    keccak_detail::keccakF1600Constexpr(lanes);
+
+    std::array<uint8_t, 32> digest{};
+    for (size_t i = 0; i < digest.size(); ++i) {
+        digest[i] = static_cast<uint8_t>(lanes[i / 8] >> (8 * (i % 8)));
+    }
+    return digest;
+}
+
+#endif // KECCAK_CONSTEXPR_H
@@ -0,0 +1,284 @@
+// keccak_multibuffer.h - Multi-buffer Keccak-256 over interleaved SIMD state lanes
+#ifndef KECCAK_MULTIBUFFER_H
+#define KECCAK_MULTIBUFFER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+
+#include "keccak.h"
+#include "../cpu/cpu_dispatch.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define KECCAK_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define KECCAK_HAVE_X86_SIMD 0
+#endif
+
+namespace keccak_detail {
+
+    // Pad the tail of one message into a full rate block (Keccak 0x01 ... 0x80 padding).
+    inline void padFinalBlock(const uint8_t* tail, size_t tailLength, uint8_t* block) noexcept {
+        std::memset(block, 0, KECCAK256_RATE);
+        std::memcpy(block, tail, tailLength);
+        block[tailLength] ^= 0x01;
+        block[KECCAK256_RATE - 1] ^= 0x80;
+    }
+
+    // One interleaved round shared by the SIMD kernels: theta, rho + pi into B,
+    // chi back into A, then iota. Lane i of every vector belongs to message i.
+#define KECCAK_SIMD_ROUND(A, B, C, D, XOR, XOR5, ROTL, CHI, SET1, rc) \
+    _Pragma("GCC unroll 5") \
+    for (int x = 0; x < 5; ++x) { \
+        C[x] = XOR5(A[x], A[x + 5], A[x + 10], A[x + 15], A[x + 20]); \
+    } \
+    _Pragma("GCC unroll 5") \
+    for (int x = 0; x < 5; ++x) { \
+        D[x] = XOR(C[(x + 4) % 5], ROTL(C[(x + 1) % 5], 1)); \
+    } \
+    _Pragma("GCC unroll 25") \
+    for (int i = 0; i < 25; ++i) { \
+        A[i] = XOR(A[i], D[i % 5]); \
+    } \
+    B[0] = A[0];                B[1] = ROTL(A[6], 44);   B[2] = ROTL(A[12], 43); \
+    B[3] = ROTL(A[18], 21);     B[4] = ROTL(A[24], 14);  B[5] = ROTL(A[3], 28); \
+    B[6] = ROTL(A[9], 20);      B[7] = ROTL(A[10], 3);   B[8] = ROTL(A[16], 45); \
+    B[9] = ROTL(A[22], 61);     B[10] = ROTL(A[1], 1);   B[11] = ROTL(A[7], 6); \
+    B[12] = ROTL(A[13], 25);    B[13] = ROTL(A[19], 8);  B[14] = ROTL(A[20], 18); \
+    B[15] = ROTL(A[4], 27);     B[16] = ROTL(A[5], 36);  B[17] = ROTL(A[11], 10); \
+    B[18] = ROTL(A[17], 15);    B[19] = ROTL(A[23], 56); B[20] = ROTL(A[2], 62); \
+    B[21] = ROTL(A[8], 55);     B[22] = ROTL(A[14], 39); B[23] = ROTL(A[15], 41); \
+    B[24] = ROTL(A[21], 2); \
+    _Pragma("GCC unroll 5") \
+    for (int y = 0; y < 25; y += 5) { \
+        _Pragma("GCC unroll 5") \
+        for (int x = 0; x < 5; ++x) { \
+            A[y + x] = CHI(B[y + x], B[y + (x + 1) % 5], B[y + (x + 2) % 5]); \
+        } \
+    } \
+    A[0] = XOR(A[0], SET1(static_cast<long long>(rc)));
+
+#if KECCAK_HAVE_X86_SIMD
+
+#define KECCAK_AVX2_XOR(a, b) _mm256_xor_si256((a), (b))
+#define KECCAK_AVX2_XOR5(a, b, c, d, e) \
+    _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256((a), (b)), _mm256_xor_si256((c), (d))), (e))
+#define KECCAK_AVX2_ROTL(v, n) _mm256_or_si256(_mm256_slli_epi64((v), (n)), _mm256_srli_epi64((v), 64 - (n)))
+#define KECCAK_AVX2_CHI(a, b, c) _mm256_xor_si256((a), _mm256_andnot_si256((b), (c)))
+
+    /**
+     * @brief Keccak-f[1600] over four interleaved states (AVX2).
+     * @param A 25 vectors; 64-bit element k of A[i] is lane i of state k.
+     */
+    __attribute__((target("avx2")))
+    inline void keccakF1600x4(__m256i* A) noexcept {
+        __m256i B[25], C[5], D[5];
+        for (int round = 0; round < 24; ++round) {
+            KECCAK_SIMD_ROUND(A, B, C, D, KECCAK_AVX2_XOR, KECCAK_AVX2_XOR5, KECCAK_AVX2_ROTL,
+                              KECCAK_AVX2_CHI, _mm256_set1_epi64x, KECCAK_ROUND_CONSTANTS[round])
+        }
+    }
+
+    /**
+     * @brief Keccak-256 of four equal-length messages in one permutation sweep (AVX2).
+     * @param messages Four input pointers.
+     * @param length Length in bytes shared by all four messages.
+     * @param digests Four output pointers, each receiving 32 bytes.
+     */
+    __attribute__((target("avx2")))
+    inline void keccak256x4(const uint8_t* const* messages, size_t length, uint8_t* const* digests) noexcept {
+        __m256i A[25];
+        for (auto& lane : A) {
+            lane = _mm256_setzero_si256();
+        }
+        const uint8_t* m0 = messages[0];
+        const uint8_t* m1 = messages[1];
+        const uint8_t* m2 = messages[2];
+        const uint8_t* m3 = messages[3];
+        constexpr size_t rateLanes = KECCAK256_RATE / 8;
+        auto absorbBlock = [&](const uint8_t* b0, const uint8_t* b1, const uint8_t* b2, const uint8_t* b3)
+            __attribute__((target("avx2"))) {
+            for (size_t j = 0; j < rateLanes; ++j) {
+                const __m256i v = _mm256_set_epi64x(
+                    static_cast<long long>(loadLane(b3 + 8 * j)), static_cast<long long>(loadLane(b2 + 8 * j)),
+                    static_cast<long long>(loadLane(b1 + 8 * j)), static_cast<long long>(loadLane(b0 + 8 * j)));
+                A[j] = _mm256_xor_si256(A[j], v);
+            }
+            keccakF1600x4(A);
+        };
+
+        size_t offset = 0;
+        for (; length - offset >= KECCAK256_RATE; offset += KECCAK256_RATE) {
+            absorbBlock(m0 + offset, m1 + offset, m2 + offset, m3 + offset);
+        }
+        alignas(32) uint8_t tail[4][KECCAK256_RATE];
+        const size_t tailLength = length - offset;
+        padFinalBlock(m0 + offset, tailLength, tail[0]);
+        padFinalBlock(m1 + offset, tailLength, tail[1]);
+        padFinalBlock(m2 + offset, tailLength, tail[2]);
+        padFinalBlock(m3 + offset, tailLength, tail[3]);
+        absorbBlock(tail[0], tail[1], tail[2], tail[3]);
+
+        alignas(32) uint64_t out[4][4];
+        for (int j = 0; j < 4; ++j) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(out[j]), A[j]);
+        }
+        for (int k = 0; k < 4; ++k) {
+            for (int j = 0; j < 4; ++j) {
+                storeLane(digests[k] + 8 * j, out[j][k]);
+            }
+        }
+    }
+
+#define KECCAK_AVX512_XOR(a, b) _mm512_xor_si512((a), (b))
+#define KECCAK_AVX512_XOR5(a, b, c, d, e) \
+    _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64((a), (b), (c), 0x96), (d), (e), 0x96)
+// Full-mask zeroing form: same vprolq, but GCC's unmasked _mm512_rol_epi64 passes an
+// uninitialized pass-through vector and warns (-Wuninitialized) at every use.
+#define KECCAK_AVX512_ROTL(v, n) _mm512_maskz_rol_epi64(0xFF, (v), (n))
+#define KECCAK_AVX512_CHI(a, b, c) _mm512_ternarylogic_epi64((a), (b), (c), 0xD2)
+
+    /**
+     * @brief Keccak-f[1600] over eight interleaved states (AVX-512F).
+     * @param A 25 vectors; 64-bit element k of A[i] is lane i of state k.
+     * @note Native rotates and ternary logic fold theta's parity and chi into single instructions.
+     */
+    __attribute__((target("avx512f")))
+    inline void keccakF1600x8(__m512i* A) noexcept {
+        __m512i B[25], C[5], D[5];
+        for (int round = 0; round < 24; ++round) {
+            KECCAK_SIMD_ROUND(A, B, C, D, KECCAK_AVX512_XOR, KECCAK_AVX512_XOR5, KECCAK_AVX512_ROTL,
+                              KECCAK_AVX512_CHI, _mm512_set1_epi64, KECCAK_ROUND_CONSTANTS[round])
+        }
+    }
+
+    /**
+     * @brief Keccak-256 of eight equal-length messages in one permutation sweep (AVX-512F).
+     * @param messages Eight input pointers.
+     * @param length Length in bytes shared by all eight messages.
+     * @param digests Eight output pointers, each receiving 32 bytes.
+     */
+    __attribute__((target("avx512f")))
+    inline void keccak256x8(const uint8_t* const* messages, size_t length, uint8_t* const* digests) noexcept {
+        __m512i A[25];
+        for (auto& lane : A) {
+            lane = _mm512_setzero_si512();
+        }
+        constexpr size_t rateLanes = KECCAK256_RATE / 8;
+        auto absorbBlock = [&](const uint8_t* const* blocks) __attribute__((target("avx512f"))) {
+            for (size_t j = 0; j < rateLanes; ++j) {
+                const __m512i v = _mm512_set_epi64(
+                    static_cast<long long>(loadLane(blocks[7] + 8 * j)), static_cast<long long>(loadLane(blocks[6] + 8 * j)),
+                    static_cast<long long>(loadLane(blocks[5] + 8 * j)), static_cast<long long>(loadLane(blocks[4] + 8 * j)),
+                    static_cast<long long>(loadLane(blocks[3] + 8 * j)), static_cast<long long>(loadLane(blocks[2] + 8 * j)),
+                    static_cast<long long>(loadLane(blocks[1] + 8 * j)), static_cast<long long>(loadLane(blocks[0] + 8 * j)));
+                A[j] = _mm512_xor_si512(A[j], v);
+            }
+            keccakF1600x8(A);
+        };
+
+        const uint8_t* blocks[8];
+        size_t offset = 0;
+        for (; length - offset >= KECCAK256_RATE; offset += KECCAK256_RATE) {
+            for (int k = 0; k < 8; ++k) {
+                blocks[k] = messages[k] + offset;
+            }
+            absorbBlock(blocks);
+        }
+        alignas(64) uint8_t tail[8][KECCAK256_RATE];
+        for (int k = 0; k < 8; ++k) {
+            padFinalBlock(messages[k] + offset, length - offset, tail[k]);
+            blocks[k] = tail[k];
+        }
+        absorbBlock(blocks);
+
+        alignas(64) uint64_t out[4][8];
+        for (int j = 0; j < 4; ++j) {
+            _mm512_store_si512(reinterpret_cast<__m512i*>(out[j]), A[j]);
+        }
+        for (int k = 0; k < 8; ++k) {
+            for (int j = 0; j < 4; ++j) {
+                storeLane(digests[k] + 8 * j, out[j][k]);
+            }
+        }
+    }
+
+#undef KECCAK_AVX2_XOR
+#undef KECCAK_AVX2_XOR5
+#undef KECCAK_AVX2_ROTL
+#undef KECCAK_AVX2_CHI
+#undef KECCAK_AVX512_XOR
+#undef KECCAK_AVX512_XOR5
+#undef KECCAK_AVX512_ROTL
+#undef KECCAK_AVX512_CHI
+
+#endif // KECCAK_HAVE_X86_SIMD
+
+#undef KECCAK_SIMD_ROUND
+
+    // Widest multi-buffer kernel the running CPU (and KECCAK_CPU_LEVEL) allows: 8, 4, or 1 (scalar).
+    inline size_t detectMultiBufferWidth() {
+        size_t width = 1;
+#if KECCAK_HAVE_X86_SIMD
+        if (cpu::supports(cpu::Feature::AVX512F)) {
+            width = 8;
+        } else if (cpu::supports(cpu::Feature::AVX2)) {
+            width = 4;
+        }
+#endif
+        cpu::recordSelection("keccak256_multibuffer", width == 8 ? "avx512x8" : width == 4 ? "avx2x4" : "scalar");
+        return width;
+    }
+
+} // namespace keccak_detail
+
+/**
+ * @brief Number of messages hashed per permutation sweep on this host.
+ * @return 8 with AVX-512F, 4 with AVX2, otherwise 1 (scalar fallback).
+ */
+inline size_t keccak256MultiBufferWidth() noexcept {
+    static const size_t width = keccak_detail::detectMultiBufferWidth();
+    return width;
+}
+
+namespace keccak_detail {
+    // Bind the multi-buffer width during static initialization, before main.
+    inline const size_t boundMultiBufferWidth = keccak256MultiBufferWidth();
+}
+
+/**
+ * @brief Keccak-256 of many independent equal-length messages.
+ *
+ * Messages are processed in groups of keccak256MultiBufferWidth() through
+ * interleaved SIMD state; any remainder (and every message on hosts without
+ * AVX2) goes through the scalar Keccak256 path. Results are bit-identical.
+ *
+ * @param messages Array of `count` input pointers.
+ * @param length Length in bytes shared by all messages.
+ * @param digests Array of `count` output pointers, each receiving 32 bytes.
+ * @param count Number of messages.
+ */
+inline void keccak256MultiBuffer(const uint8_t* const* messages, size_t length,
+                                 uint8_t* const* digests, size_t count) noexcept {
+    size_t i = 0;
+#if KECCAK_HAVE_X86_SIMD
+    const size_t width = keccak256MultiBufferWidth();
+    if (width == 8) {
+        for (; count - i >= 8; i += 8) {
+            keccak_detail::keccak256x8(messages + i, length, digests + i);
+        }
+    }
+    if (width >= 4) {
+        for (; count - i >= 4; i += 4) {
+            keccak_detail::keccak256x4(messages + i, length, digests + i);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        keccak256(messages[i], length, digests[i]);
+    }
+}
+
+#endif // KECCAK_MULTIBUFFER_H
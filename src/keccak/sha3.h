@@ -0,0 +1,119 @@
+// sha3.h - Incremental SHA3 / SHAKE / Keccak hashers over the shared KeccakState sponge
+#ifndef KECCAK_SHA3_H
+#define KECCAK_SHA3_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "keccak.h"
+
+// Domain-separation bytes applied by KeccakState::finalize().
+inline constexpr uint8_t KECCAK_PADDING = 0x01; // original Keccak (Ethereum keccak256)
+inline constexpr uint8_t SHA3_PADDING = 0x06;   // FIPS-202 SHA3-*
+inline constexpr uint8_t SHAKE_PADDING = 0x1F;  // FIPS-202 SHAKE*
+
+/**
+ * @brief Incremental sponge hasher: absorb with update(), then squeeze output in pieces.
+ *
+ * One template covers Keccak, SHA3 and SHAKE; they differ only in rate and padding.
+ * update() may be called any number of times with chunks of any size. The first
+ * squeeze() applies the padding; later calls continue the output stream exactly where
+ * the previous one stopped, writing straight into the caller's buffer, so an XOF stream
+ * of any length is produced without allocating.
+ *
+ * @tparam Rate Sponge rate in bytes (200 - 2 * security bytes; a multiple of 8).
+ * @tparam Padding Domain separation byte (KECCAK_PADDING, SHA3_PADDING or SHAKE_PADDING).
+ * @tparam DigestSize Fixed output size for final(), or 0 for an extendable-output function.
+ */
+template <size_t Rate, uint8_t Padding, size_t DigestSize>
+class KeccakSponge {
+    static_assert(Rate % 8 == 0 && Rate < KECCAK_STATE_SIZE, "rate must be a whole number of lanes");
+
+public:
+    static constexpr size_t RATE = Rate;
+    static constexpr size_t DIGESTSIZE = DigestSize;
+
+    KeccakSponge() noexcept = default;
+
+    // Discard all input and output and start a new message.
+    void reset() noexcept {
+        state_.reset();
+        squeezing_ = false;
+    }
+
+    /**
+     * @brief Absorb a chunk of input.
+     * @note Must not be called after squeeze() without a reset() in between.
+     */
+    void update(const uint8_t* data, size_t length) noexcept {
+        state_.absorb(data, length, Rate);
+    }
+
+    /**
+     * @brief Write the next `length` output bytes.
+     * @note The first call finishes absorbing. Successive calls return consecutive bytes
+     *       of one output stream, so squeeze(a, 10); squeeze(b, 20) equals squeeze(ab, 30).
+     */
+    void squeeze(uint8_t* output, size_t length) noexcept {
+        if (!squeezing_) {
+            state_.finalize(Padding, Rate);
+            squeezing_ = true;
+        }
+        state_.squeeze(output, length, Rate);
+    }
+
+    // Write the DIGESTSIZE-byte digest and reset for the next message.
+    void final(uint8_t* digest) noexcept {
+        static_assert(DigestSize != 0, "final() needs a fixed-size digest; use squeeze() for XOFs");
+        squeeze(digest, DigestSize);
+        reset();
+    }
+
+private:
+    KeccakState state_;
+    bool squeezing_ = false;
+};
+
+using Sha3_224 = KeccakSponge<144, SHA3_PADDING, 28>;
+using Sha3_256 = KeccakSponge<136, SHA3_PADDING, 32>;
+using Sha3_384 = KeccakSponge<104, SHA3_PADDING, 48>;
+using Sha3_512 = KeccakSponge<72, SHA3_PADDING, 64>;
+using Shake128 = KeccakSponge<168, SHAKE_PADDING, 0>;
+using Shake256 = KeccakSponge<136, SHAKE_PADDING, 0>;
+using Keccak224 = KeccakSponge<144, KECCAK_PADDING, 28>;
+using Keccak256Sponge = KeccakSponge<136, KECCAK_PADDING, 32>;
+using Keccak384 = KeccakSponge<104, KECCAK_PADDING, 48>;
+using Keccak512 = KeccakSponge<72, KECCAK_PADDING, 64>;
+
+namespace keccak_detail {
+
+    template <typename Sponge>
+    inline void oneShot(const uint8_t* data, size_t length, uint8_t* output, size_t outputLength) noexcept {
+        Sponge sponge;
+        sponge.update(data, length);
+        sponge.squeeze(output, outputLength);
+    }
+
+} // namespace keccak_detail
+
+// One-shot helpers writing into caller buffers (digest buffers must hold the full digest).
+inline void sha3_224(const uint8_t* data, size_t length, uint8_t* digest) noexcept {
+    keccak_detail::oneShot<Sha3_224>(data, length, digest, Sha3_224::DIGESTSIZE);
+}
+inline void sha3_256(const uint8_t* data, size_t length, uint8_t* digest) noexcept {
+    keccak_detail::oneShot<Sha3_256>(data, length, digest, Sha3_256::DIGESTSIZE);
+}
+inline void sha3_384(const uint8_t* data, size_t length, uint8_t* digest) noexcept {
+    keccak_detail::oneShot<Sha3_384>(data, length, digest, Sha3_384::DIGESTSIZE);
+}
+inline void sha3_512(const uint8_t* data, size_t length, uint8_t* digest) noexcept {
+    keccak_detail::oneShot<Sha3_512>(data, length, digest, Sha3_512::DIGESTSIZE);
+}
+inline void shake128(const uint8_t* data, size_t length, uint8_t* output, size_t outputLength) noexcept {
+    keccak_detail::oneShot<Shake128>(data, length, output, outputLength);
+}
+inline void shake256(const uint8_t* data, size_t length, uint8_t* output, size_t outputLength) noexcept {
+    keccak_detail::oneShot<Shake256>(data, length, output, outputLength);
+}
+
+#endif // KECCAK_SHA3_H
@@ -0,0 +1,813 @@
+// Long-running Keccak / address service over a Unix domain socket.
+//
+// Usage: keccak_daemon <socket-path> [--workers N]
+//        keccak_daemon --client <socket-path> [file|-]
+//
+// Server: one epoll thread accepts connections, cuts complete request frames out of
+// each connection's input and queues them; a fixed pool of workers takes queued
+// requests in groups (deriving the addresses of a group eight at a time with the
+// multi-buffer Keccak-256) and hands finished response frames back to the epoll
+// thread through an eventfd. Requests may be pipelined: a client can send any number
+// of frames without waiting, and every response carries the id of its request.
+// Responses can arrive out of order. SIGINT/SIGTERM stop the server.
+//
+// Frames (all integers little-endian):
+//   request:  u32 length | u32 id | u8 op     | payload    (length counts id, op and payload)
+//   response: u32 length | u32 id | u8 status | payload
+//   op 1 hash:        payload = message bytes           -> 32-byte Keccak-256
+//   op 2 derive:      payload = 64-byte public key, or 65 bytes starting with 0x04
+//                                                       -> 20-byte address || 42-char EIP-55 text
+//   op 3 validate:    payload = candidate hash string   -> 1 byte, 1 if 64 hex digits (optional 0x)
+//   op 4 verify55:    payload = address text            -> 1 byte, 1 if the EIP-55 checksum matches
+//   status: 0 ok, 1 malformed payload, 2 unknown op
+//
+// Client: reads "<op> <argument>" lines (op is hash, derive, validate or verify55;
+// hash and derive take hex), sends them all pipelined and prints one result per line
+// in input order. It exists to exercise the daemon locally.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "keccak/keccak.h"
+#include "eth/address_batch.h"
+#include "eth/eip55.h"
+#include "eth/hex.h"
+#include "hash_validation/batch_validation.h"
+
+enum Op : uint8_t {
+    OP_HASH = 1,
+    OP_DERIVE = 2,
+    OP_VALIDATE = 3,
+    OP_VERIFY_EIP55 = 4,
+};
+
+enum Status : uint8_t {
+    STATUS_OK = 0,
+    STATUS_MALFORMED = 1,
+    STATUS_UNKNOWN_OP = 2,
+};
+
+// Bytes after the length field: id (4) and op/status (1).
+constexpr size_t FRAME_HEADER = 5;
+// Largest accepted value of the length field; larger frames close the connection.
+constexpr uint32_t MAX_FRAME = 16 << 20;
+// Requests a worker takes from the queue at once.
+constexpr size_t WORKER_BATCH = 64;
+// Per-connection limits: reading pauses while either is exceeded.
+constexpr size_t MAX_IN_FLIGHT = 4096;
+constexpr size_t MAX_PENDING_OUTPUT = 8 << 20;
+constexpr size_t READ_SIZE = 64 << 10;
+
+static void putU32(std::string& out, uint32_t value) {
+    const char bytes[4] = { static_cast<char>(value), static_cast<char>(value >> 8),
+                            static_cast<char>(value >> 16), static_cast<char>(value >> 24) };
+    out.append(bytes, 4);
+}
+
+static uint32_t getU32(const char* p) {
+    const auto* b = reinterpret_cast<const unsigned char*>(p);
+    return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+}
+
+static void appendFrame(std::string& out, uint32_t id, uint8_t code, const void* payload, size_t size) {
+    putU32(out, static_cast<uint32_t>(FRAME_HEADER + size));
+    putU32(out, id);
+    out.push_back(static_cast<char>(code));
+    out.append(static_cast<const char*>(payload), size);
+}
+
+static sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+// ---- Server ----
+
+struct Job {
+    uint64_t connection;
+    uint32_t id;
+    uint8_t op;
+    std::string payload;
+};
+
+struct Completion {
+    uint64_t connection;
+    size_t responses;
+    std::string frames;
+};
+
+// Requests waiting for a worker.
+class JobQueue {
+public:
+    void push(std::vector<Job>& jobs) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Job& job : jobs) {
+                jobs_.push_back(std::move(job));
+            }
+        }
+        jobs.clear();
+        ready_.notify_all();
+    }
+
+    // Block until jobs are available; takes up to `max`. Returns false once closed and drained.
+    bool pop(std::vector<Job>& out, size_t max) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [&] { return closed_ || !jobs_.empty(); });
+        if (jobs_.empty()) {
+            return false;
+        }
+        while (!jobs_.empty() && out.size() < max) {
+            out.push_back(std::move(jobs_.front()));
+            jobs_.pop_front();
+        }
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        ready_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Job> jobs_;
+    bool closed_ = false;
+};
+
+// Finished response frames travelling back to the epoll thread, which is woken through an eventfd.
+class CompletionQueue {
+public:
+    explicit CompletionQueue(int eventFd) : eventFd_(eventFd) {}
+
+    void push(std::vector<Completion>& completions) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Completion& c : completions) {
+                items_.push_back(std::move(c));
+            }
+        }
+        completions.clear();
+        const uint64_t one = 1;
+        while (write(eventFd_, &one, sizeof(one)) < 0 && errno == EINTR) {
+        }
+    }
+
+    void drain(std::vector<Completion>& out) {
+        uint64_t count;
+        while (read(eventFd_, &count, sizeof(count)) < 0 && errno == EINTR) {
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        out.swap(items_);
+    }
+
+private:
+    int eventFd_;
+    std::mutex mutex_;
+    std::vector<Completion> items_;
+};
+
+// Answer a group of jobs. Derive requests of the group are hashed together.
+static void processJobs(std::vector<Job>& jobs, std::vector<Completion>& completions) {
+    std::vector<const eth::Byte*> keys;
+    std::vector<size_t> keyJob;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        const Job& job = jobs[j];
+        if (job.op != OP_DERIVE) {
+            continue;
+        }
+        const auto* payload = reinterpret_cast<const eth::Byte*>(job.payload.data());
+        if (job.payload.size() == 64) {
+            keys.push_back(payload);
+            keyJob.push_back(j);
+        } else if (job.payload.size() == 65 && payload[0] == 0x04) {
+            keys.push_back(payload + 1);
+            keyJob.push_back(j);
+        }
+    }
+    std::vector<eth::AddressBytes> addresses(keys.size());
+    std::vector<eth::AddressString> text(keys.size());
+    for (size_t first = 0; first < keys.size(); first += eth::address_detail::CHUNK_SIZE) {
+        const size_t count = std::min(eth::address_detail::CHUNK_SIZE, keys.size() - first);
+        eth::address_detail::hashKeyChunk(keys.data() + first, count, addresses[first].data());
+        eth::toEIP55Batch(addresses[first].data(), count, text.data() + first);
+    }
+
+    std::vector<size_t> derived(jobs.size(), SIZE_MAX);
+    for (size_t k = 0; k < keyJob.size(); ++k) {
+        derived[keyJob[k]] = k;
+    }
+    // Group responses per connection so each reaches the epoll thread as one append.
+    std::unordered_map<uint64_t, size_t> slot;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        const Job& job = jobs[j];
+        auto [it, inserted] = slot.try_emplace(job.connection, completions.size());
+        if (inserted) {
+            completions.push_back(Completion{ job.connection, 0, {} });
+        }
+        Completion& c = completions[it->second];
+        ++c.responses;
+        switch (job.op) {
+            case OP_HASH: {
+                uint8_t digest[Keccak256::DIGESTSIZE];
+                keccak256(reinterpret_cast<const uint8_t*>(job.payload.data()), job.payload.size(), digest);
+                appendFrame(c.frames, job.id, STATUS_OK, digest, sizeof(digest));
+                break;
+            }
+            case OP_DERIVE: {
+                if (derived[j] == SIZE_MAX) {
+                    appendFrame(c.frames, job.id, STATUS_MALFORMED, nullptr, 0);
+                    break;
+                }
+                char out[20 + 42];
+                std::memcpy(out, addresses[derived[j]].data(), 20);
+                std::memcpy(out + 20, text[derived[j]].data(), 42);
+                appendFrame(c.frames, job.id, STATUS_OK, out, sizeof(out));
+                break;
+            }
+            case OP_VALIDATE: {
+                const uint8_t valid = hash_validation::isKeccak256Record(job.payload.data(), job.payload.size());
+                appendFrame(c.frames, job.id, STATUS_OK, &valid, 1);
+                break;
+            }
+            case OP_VERIFY_EIP55: {
+                const uint8_t valid = eth::verifyEIP55(job.payload);
+                appendFrame(c.frames, job.id, STATUS_OK, &valid, 1);
+                break;
+            }
+            default:
+                appendFrame(c.frames, job.id, STATUS_UNKNOWN_OP, nullptr, 0);
+                break;
+        }
+    }
+    jobs.clear();
+}
+
+struct Connection {
+    uint64_t key = 0;
+    int fd = -1;
+    std::string input{};
+    std::string output{};
+    size_t outputOffset = 0;
+    size_t inFlight = 0;
+    uint32_t events = 0;     // currently registered epoll events (0: unregistered)
+    bool readClosed = false; // peer finished sending (or a protocol error)
+};
+
+class Server {
+public:
+    Server(std::string path, size_t workers) : path_(std::move(path)), workers_(workers) {}
+
+    ~Server() {
+        for (auto& [id, connection] : connections_) {
+            close(connection.fd);
+        }
+        for (int fd : { listenFd_, epollFd_, eventFd_, signalFd_ }) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        if (bound_) {
+            unlink(path_.c_str());
+        }
+    }
+
+    bool run() {
+        if (!setUp()) {
+            return false;
+        }
+        CompletionQueue completions(eventFd_);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < workers_; ++i) {
+            threads.emplace_back([&] {
+                std::vector<Job> jobs;
+                std::vector<Completion> done;
+                while (jobs_.pop(jobs, WORKER_BATCH)) {
+                    processJobs(jobs, done);
+                    completions.push(done);
+                }
+            });
+        }
+        std::cerr << "listening on " << path_ << " with " << workers_ << " workers\n";
+
+        bool ok = true;
+        std::vector<epoll_event> events(64);
+        std::vector<Completion> finished;
+        while (!stopping_) {
+            const int n = epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), -1);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "Error: epoll_wait: " << std::strerror(errno) << '\n';
+                ok = false;
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                const uint64_t key = events[i].data.u64;
+                if (key == LISTEN_KEY) {
+                    acceptAll();
+                } else if (key == EVENT_KEY) {
+                    completions.drain(finished);
+                    for (Completion& c : finished) {
+                        deliver(c);
+                    }
+                    finished.clear();
+                } else if (key == SIGNAL_KEY) {
+                    stopping_ = true;
+                } else {
+                    handleConnection(key, events[i].events);
+                }
+            }
+        }
+
+        jobs_.close();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::cerr << "served " << requests_ << " requests on " << accepted_ << " connections\n";
+        return ok;
+    }
+
+private:
+    static constexpr uint64_t LISTEN_KEY = 0;
+    static constexpr uint64_t EVENT_KEY = 1;
+    static constexpr uint64_t SIGNAL_KEY = 2;
+
+    bool setUp() {
+        // Stop on SIGINT/SIGTERM through a signalfd; block them before any thread starts.
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        signalFd_ = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+        eventFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+        listenFd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (signalFd_ < 0 || eventFd_ < 0 || epollFd_ < 0 || listenFd_ < 0) {
+            std::cerr << "Error: cannot create descriptors: " << std::strerror(errno) << '\n';
+            return false;
+        }
+
+        // Replace a stale socket left by an earlier run, but never any other kind of file.
+        struct stat info{};
+        if (lstat(path_.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+            unlink(path_.c_str());
+        }
+        const sockaddr_un address = socketAddress(path_);
+        if (bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+            std::cerr << "Error: cannot bind " << path_ << ": " << std::strerror(errno) << '\n';
+            return false;
+        }
+        bound_ = true;
+        if (listen(listenFd_, SOMAXCONN) < 0) {
+            std::cerr << "Error: cannot listen on " << path_ << ": " << std::strerror(errno) << '\n';
+            return false;
+        }
+        return watch(listenFd_, LISTEN_KEY, EPOLLIN) && watch(eventFd_, EVENT_KEY, EPOLLIN) &&
+               watch(signalFd_, SIGNAL_KEY, EPOLLIN);
+    }
+
+    bool watch(int fd, uint64_t key, uint32_t events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = key;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            std::cerr << "Error: epoll_ctl: " << std::strerror(errno) << '\n';
+            return false;
+        }
+        return true;
+    }
+
+    void acceptAll() {
+        while (true) {
+            const int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return; // EAGAIN, or a transient error such as EMFILE
+            }
+            const uint64_t key = nextKey_++;
+            Connection& connection = connections_.emplace(key, Connection{ key, fd }).first->second;
+            connection.events = EPOLLIN;
+            if (!watch(fd, key, EPOLLIN)) {
+                close(fd);
+                connections_.erase(key);
+                continue;
+            }
+            ++accepted_;
+        }
+    }
+
+    void handleConnection(uint64_t key, uint32_t events) {
+        auto it = connections_.find(key);
+        if (it == connections_.end()) {
+            return;
+        }
+        Connection& connection = it->second;
+        if (events & (EPOLLHUP | EPOLLERR)) {
+            // Both directions are gone; reading is skipped even while paused, so the hangup
+            // cannot be reported again and again until the outstanding requests finish.
+            dropPeer(connection);
+        } else if (events & EPOLLIN) {
+            readInput(connection);
+        }
+        if (events & EPOLLOUT) {
+            flush(connection);
+        }
+        update(key, connection);
+    }
+
+    void readInput(Connection& connection) {
+        char buffer[READ_SIZE];
+        while (!connection.readClosed && !paused(connection)) {
+            const ssize_t n = read(connection.fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                connection.input.append(buffer, static_cast<size_t>(n));
+                parseFrames(connection);
+            } else if (n == 0 || (errno != EINTR && errno != EAGAIN)) {
+                connection.readClosed = true;
+            } else if (errno == EAGAIN) {
+                break;
+            }
+        }
+    }
+
+    bool paused(const Connection& connection) const noexcept {
+        return connection.inFlight >= MAX_IN_FLIGHT ||
+               connection.output.size() - connection.outputOffset >= MAX_PENDING_OUTPUT;
+    }
+
+    // Queue every complete frame in the input buffer (stopping early while paused).
+    void parseFrames(Connection& connection) {
+        std::vector<Job> batch;
+        size_t offset = 0;
+        const std::string& in = connection.input;
+        while (!connection.readClosed && !paused(connection) && in.size() - offset >= 4) {
+            const uint32_t length = getU32(in.data() + offset);
+            if (length < FRAME_HEADER || length > MAX_FRAME) {
+                // Unrecoverable framing error: stop reading; answered requests are still sent.
+                connection.readClosed = true;
+                offset = in.size();
+                break;
+            }
+            if (in.size() - offset - 4 < length) {
+                break;
+            }
+            const char* frame = in.data() + offset + 4;
+            batch.push_back(Job{ connection.key, getU32(frame), static_cast<uint8_t>(frame[4]),
+                                 std::string(frame + FRAME_HEADER, length - FRAME_HEADER) });
+            ++connection.inFlight;
+            ++requests_;
+            offset += 4 + length;
+        }
+        connection.input.erase(0, offset);
+        if (!batch.empty()) {
+            jobs_.push(batch);
+        }
+    }
+
+    void deliver(Completion& completion) {
+        auto it = connections_.find(completion.connection);
+        if (it == connections_.end()) {
+            return; // the connection went away while its requests were being answered
+        }
+        Connection& connection = it->second;
+        connection.inFlight -= completion.responses;
+        connection.output.append(completion.frames);
+        flush(connection);
+        // Input held back while paused may now fit. Once reading has stopped there is nothing
+        // left to parse: EOF leaves at most a partial frame, and a dead peer gets no answers.
+        if (!connection.readClosed && !connection.input.empty()) {
+            parseFrames(connection);
+        }
+        update(completion.connection, connection);
+    }
+
+    void flush(Connection& connection) {
+        while (connection.outputOffset < connection.output.size()) {
+            const ssize_t n = send(connection.fd, connection.output.data() + connection.outputOffset,
+                                   connection.output.size() - connection.outputOffset, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno != EAGAIN) {
+                    dropPeer(connection);
+                }
+                break;
+            }
+            connection.outputOffset += static_cast<size_t>(n);
+        }
+        if (connection.outputOffset == connection.output.size()) {
+            connection.output.clear();
+            connection.outputOffset = 0;
+        } else if (connection.outputOffset > (1 << 20)) {
+            connection.output.erase(0, connection.outputOffset);
+            connection.outputOffset = 0;
+        }
+    }
+
+    // The peer is gone: drop what it will never read, and its unparsed requests.
+    static void dropPeer(Connection& connection) {
+        connection.readClosed = true;
+        connection.input.clear();
+        connection.output.clear();
+        connection.outputOffset = 0;
+    }
+
+    // Close finished connections and keep the epoll registration in line with the connection state.
+    void update(uint64_t key, Connection& connection) {
+        const bool outputPending = connection.outputOffset < connection.output.size();
+        if (connection.readClosed && connection.inFlight == 0 && !outputPending) {
+            close(connection.fd);
+            connections_.erase(key);
+            return;
+        }
+        const uint32_t wanted = (connection.readClosed || paused(connection) ? 0u : uint32_t(EPOLLIN)) |
+                                (outputPending ? uint32_t(EPOLLOUT) : 0u);
+        if (wanted != connection.events) {
+            // A connection waiting only for its answers is unregistered rather than left with
+            // an empty mask: epoll reports EPOLLHUP and EPOLLERR regardless of the mask.
+            const int op = wanted == 0 ? EPOLL_CTL_DEL : connection.events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+            epoll_event event{};
+            event.events = wanted;
+            event.data.u64 = key;
+            epoll_ctl(epollFd_, op, connection.fd, &event);
+            connection.events = wanted;
+        }
+    }
+
+    std::string path_;
+    size_t workers_;
+    int listenFd_ = -1;
+    int epollFd_ = -1;
+    int eventFd_ = -1;
+    int signalFd_ = -1;
+    bool bound_ = false;
+    bool stopping_ = false;
+    uint64_t nextKey_ = 3; // keys 0-2 identify the listening socket, eventfd and signalfd
+    std::unordered_map<uint64_t, Connection> connections_;
+    JobQueue jobs_;
+    size_t requests_ = 0;
+    size_t accepted_ = 0;
+};
+
+// ---- Client ----
+
+static bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        const ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Encode one "<op> <argument>" line as a request frame; false if the line is not understood.
+static bool encodeRequest(std::string_view line, uint32_t id, std::string& out) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    const size_t space = line.find(' ');
+    const std::string_view op = line.substr(0, space);
+    std::string_view argument = space == std::string_view::npos ? std::string_view() : line.substr(space + 1);
+    if (op == "validate" || op == "verify55") {
+        appendFrame(out, id, op == "validate" ? OP_VALIDATE : OP_VERIFY_EIP55, argument.data(), argument.size());
+        return true;
+    }
+    if (op != "hash" && op != "derive") {
+        return false;
+    }
+    if (argument.size() >= 2 && argument[0] == '0' && (argument[1] == 'x' || argument[1] == 'X')) {
+        argument.remove_prefix(2);
+    }
+    std::vector<eth::Byte> bytes(argument.size() / 2);
+    if (!eth::hexDecode(argument.data(), argument.size(), bytes.data())) {
+        return false;
+    }
+    appendFrame(out, id, op == "hash" ? OP_HASH : OP_DERIVE, bytes.data(), bytes.size());
+    return true;
+}
+
+static std::string describeResponse(uint8_t status, const char* payload, size_t size) {
+    if (status == STATUS_MALFORMED) {
+        return "error malformed-request";
+    }
+    if (status != STATUS_OK) {
+        return "error unknown-op";
+    }
+    if (size == 1) {
+        return payload[0] ? "valid" : "invalid";
+    }
+    if (size == 20 + 42) {
+        return std::string(payload + 20, 42);
+    }
+    std::string hex(2 * size, '\0');
+    eth::hexEncode(reinterpret_cast<const eth::Byte*>(payload), size, hex.data());
+    return hex;
+}
+
+static bool runClient(const std::string& socketPath, std::istream& in) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const sockaddr_un address = socketAddress(socketPath);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "Error: cannot connect to " << socketPath << ": " << std::strerror(errno) << '\n';
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    // Requests are written on their own thread so responses are read while the client is
+    // still sending; otherwise both sides could block on full socket buffers.
+    std::atomic<bool> sendOk{true};
+    std::vector<uint8_t> understood;
+    std::mutex understoodMutex;
+    std::thread writer([&] {
+        std::string line;
+        std::string frames;
+        uint32_t id = 0;
+        while (std::getline(in, line)) {
+            const bool ok = encodeRequest(line, id, frames);
+            {
+                std::lock_guard<std::mutex> lock(understoodMutex);
+                understood.push_back(ok);
+            }
+            ++id;
+            if (frames.size() >= (1 << 16) && !sendAll(fd, frames.data(), frames.size())) {
+                sendOk = false;
+                break;
+            }
+            if (frames.size() >= (1 << 16)) {
+                frames.clear();
+            }
+        }
+        if (sendOk && !sendAll(fd, frames.data(), frames.size())) {
+            sendOk = false;
+        }
+        shutdown(fd, SHUT_WR);
+    });
+
+    // Print results in input order; lines that were not understood get "error bad-line".
+    std::unordered_map<uint32_t, std::string> early;
+    uint32_t nextToPrint = 0;
+    size_t failed = 0;
+    auto printReady = [&] {
+        while (true) {
+            uint8_t ok;
+            {
+                std::lock_guard<std::mutex> lock(understoodMutex);
+                if (nextToPrint >= understood.size()) {
+                    return;
+                }
+                ok = understood[nextToPrint];
+            }
+            std::string text;
+            if (!ok) {
+                text = "error bad-line";
+            } else {
+                auto it = early.find(nextToPrint);
+                if (it == early.end()) {
+                    return;
+                }
+                text = std::move(it->second);
+                early.erase(it);
+            }
+            failed += text.compare(0, 6, "error ") == 0;
+            text.push_back('\n');
+            std::cout << text;
+            ++nextToPrint;
+        }
+    };
+
+    std::string buffer;
+    char chunk[READ_SIZE];
+    bool readOk = true;
+    while (true) {
+        const ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            readOk = (n == 0);
+            break;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+        size_t offset = 0;
+        while (buffer.size() - offset >= 4) {
+            const uint32_t length = getU32(buffer.data() + offset);
+            if (buffer.size() - offset - 4 < length) {
+                break;
+            }
+            const char* frame = buffer.data() + offset + 4;
+            early.emplace(getU32(frame), describeResponse(static_cast<uint8_t>(frame[4]), frame + FRAME_HEADER,
+                                                          length - FRAME_HEADER));
+            offset += 4 + length;
+        }
+        buffer.erase(0, offset);
+        printReady();
+    }
+    writer.join();
+    printReady();
+    close(fd);
+
+    const size_t requests = understood.size();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << socketPath << ": " << requests << " requests in " << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << " (" << static_cast<size_t>(static_cast<double>(requests) / seconds) << " requests/s)";
+    }
+    if (failed > 0) {
+        std::cerr << ", " << failed << " failed";
+    }
+    std::cerr << '\n';
+    if (!sendOk || !readOk || nextToPrint != requests) {
+        std::cerr << "Error: connection to " << socketPath << " failed\n";
+        return false;
+    }
+    return failed == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && std::string_view(argv[1]) == "--client") {
+        const std::string path = argc >= 4 ? argv[3] : "-";
+        std::ios::sync_with_stdio(false);
+        std::ifstream file;
+        if (path != "-") {
+            file.open(path);
+            if (!file) {
+                std::cerr << "Error: cannot open " << path << '\n';
+                return 1;
+            }
+        }
+        try {
+            return runClient(argv[2], path == "-" ? std::cin : file) ? 0 : 1;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    std::string socketPath;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--workers" && i + 1 < argc) {
+            workers = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else {
+            socketPath = arg;
+        }
+    }
+    if (socketPath.empty()) {
+        std::cerr << "Usage: keccak_daemon <socket-path> [--workers N]\n"
+                     "       keccak_daemon --client <socket-path> [file|-]\n";
+        return 1;
+    }
+    try {
+        Server server(socketPath, workers);
+        return server.run() ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -1,211 +1,589 @@
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <array>
 #include <stdexcept>
-#include <cctype>
 #include <algorithm>
 #include <string_view>
-#include <thread>
-#include <mutex>
-#include <atomic>
 #include <cstring>
-#include <cryptopp/keccak.h>
-
-namespace eth {
-
-    using Byte = unsigned char;
-
-    /**
-     * @brief Convert a vector of bytes to a hexadecimal string using a fixed-size buffer.
-     * @param bytes Input bytes.
-     * @param hexBuffer Pre-allocated buffer to store the hex string (must be at least 2*bytes.size() + 1 bytes).
-     * @note This function is noexcept as it does not throw exceptions.
-     */
-    inline void bytesToHex(const std::vector<Byte>& bytes, char* hexBuffer) noexcept {
-        constexpr char hexDigits[] = "0123456789abcdef";
-        const Byte* bytePtr = bytes.data();
-        char* hexPtr = hexBuffer;
-        for (size_t i = 0; i < bytes.size(); ++i) {
-            Byte b = bytePtr[i];
-            *hexPtr++ = hexDigits[(b >> 4) & 0x0F];
-            *hexPtr++ = hexDigits[b & 0x0F];
-        }
-        *hexPtr = '\0'; // Null-terminate the string
-    }
-
-    /**
-     * @brief Convert a hexadecimal string to a vector of bytes using a lookup table.
-     * @param hex The hex string.
-     * @return std::vector<Byte> Parsed bytes.
-     * @throws std::runtime_error if the input is invalid.
-     */
-    inline std::vector<Byte> hexToBytes(std::string_view hex) {
-        if (hex.size() % 2 != 0) {
-            throw std::runtime_error("Hex string has odd length.");
-        }
-        // Lookup table for hex digit conversion (0-15)
-        constexpr std::array<int, 256> hexLookup = []() constexpr {
-            std::array<int, 256> table{};
-            for (int i = 0; i < 256; ++i) table[i] = -1; // Invalid by default
-            for (int i = '0'; i <= '9'; ++i) table[i] = i - '0';
-            for (int i = 'a'; i <= 'f'; ++i) table[i] = i - 'a' + 10;
-            for (int i = 'A'; i <= 'F'; ++i) table[i] = i - 'A' + 10;
-            return table;
-        }();
-
-        std::vector<Byte> bytes;
-        bytes.reserve(hex.size() / 2);
-        const char* hexData = hex.data();
-        for (size_t i = 0; i < hex.size(); i += 2) {
-            char high = hexData[i];
-            char low = hexData[i + 1];
-            int highValue = hexLookup[static_cast<unsigned char>(high)];
-            int lowValue = hexLookup[static_cast<unsigned char>(low)];
-            if (highValue == -1 || lowValue == -1) {
-                throw std::runtime_error("Hex string contains invalid characters.");
-            }
-            bytes.push_back(static_cast<Byte>((highValue << 4) | lowValue));
-        }
-        return bytes;
-    }
-
-    /**
-     * @brief Apply EIP-55 checksum encoding to an Ethereum address in-place.
-     * @param addressBuffer Buffer containing the address (must be 42 bytes, starting with "0x").
-     * @param keccak Reusable Keccak-256 hash object.
-     * @throws std::runtime_error if the address format is invalid.
-     */
-    inline void toEIP55Address(char* addressBuffer, CryptoPP::Keccak_256& keccak) {
-        if (std::strlen(addressBuffer) != 42 || addressBuffer[0] != '0' || addressBuffer[1] != 'x') {
-            throw std::runtime_error("Invalid address format for EIP-55 encoding");
-        }
-        // Create a lowercase copy (40 hex characters + null terminator)
-        char addrLower[41];
-        std::strncpy(addrLower, addressBuffer + 2, 40);
-        addrLower[40] = '\0';
-        std::transform(addrLower, addrLower + 40, addrLower, ::tolower);
-
-        std::array<Byte, CryptoPP::Keccak_256::DIGESTSIZE> hash{};
-        keccak.Restart();
-        keccak.Update(reinterpret_cast<const Byte*>(addrLower), 40);
-        keccak.Final(hash.data());
-
-        // Apply checksum in-place using the hash nibbles
-        for (size_t i = 0; i < 40; ++i) {
-            size_t byteIndex = i / 2;
-            bool isHighNibble = (i % 2) == 0;
-            int hashNibble = isHighNibble ? (hash[byteIndex] >> 4) & 0x0F : hash[byteIndex] & 0x0F;
-            if (hashNibble >= 8) {
-                addressBuffer[i + 2] = std::toupper(addressBuffer[i + 2]);
-            } else {
-                addressBuffer[i + 2] = std::tolower(addressBuffer[i + 2]);
-            }
-        }
-    }
-
-    /**
-     * @brief Derive an Ethereum address from an uncompressed public key.
-     * @param publicKey The uncompressed public key.
-     * @param addressBuffer Buffer to store the resulting address (must be 43 bytes, including "0x" and null terminator).
-     * @param keccak Reusable Keccak-256 hash object.
-     * @throws std::runtime_error if the public key size is incorrect.
-     */
-    inline void deriveEthereumAddress(const std::vector<Byte>& publicKey, char* addressBuffer, CryptoPP::Keccak_256& keccak) {
-        if (publicKey.size() != 64) {
-            throw std::runtime_error("Invalid public key size. Expected 64 bytes.");
-        }
-        std::array<Byte, CryptoPP::Keccak_256::DIGESTSIZE> hash{};
-        keccak.Restart();
-        keccak.Update(publicKey.data(), publicKey.size());
-        keccak.Final(hash.data());
-
-        std::vector<Byte> addressBytes(hash.end() - 20, hash.end());
-        addressBuffer[0] = '0';
-        addressBuffer[1] = 'x';
-        bytesToHex(addressBytes, addressBuffer + 2);
-        toEIP55Address(addressBuffer, keccak);
-    }
-
-    /**
-     * @brief Parse command-line arguments for public key input.
-     * @param argc Argument count.
-     * @param argv Argument vector.
-     * @return std::vector<Byte> The parsed public key.
-     * @throws std::runtime_error if the input is invalid.
-     */
-    inline std::vector<Byte> parsePublicKey(int argc, char* argv[]) {
-        std::vector<Byte> publicKey;
-        if (argc == 2) {
-            std::string_view hexInput = argv[1];
-            if (hexInput.length() != 128) {
-                throw std::runtime_error("Invalid hex input length. Expected 128 characters (64 bytes).");
-            }
-            publicKey = hexToBytes(hexInput);
+#include <cstdlib>
+#include <cerrno>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <charconv>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "keccak/keccak.h"
+#include "eth/eip55.h"
+#include "eth/hex.h"
+#include "eth/address.h"
+#include "eth/thread_pool.h"
+#include "eth/address_batch.h"
+#include "eth/address_cache.h"
+#include "eth/address_utils.h"
+#include "eth/watchlist.h"
+#include "metrics/metrics.h"
+
+/**
+ * @brief Parse command-line arguments for public key input.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return The parsed public key.
+ * @throws std::runtime_error if the input is invalid.
+ */
+static std::vector<eth::Byte> parsePublicKey(int argc, char* argv[]) {
+    std::vector<eth::Byte> publicKey;
+    if (argc == 2) {
+        std::string_view hexInput = argv[1];
+        if (hexInput.length() != 128) {
+            throw std::runtime_error("Invalid hex input length. Expected 128 characters (64 bytes).");
+        }
+        publicKey = eth::hexToBytes(hexInput);
+    } else {
+        std::cout << "No public key provided. Using default test data.\n";
+        publicKey = {
+            0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0,
+            0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88,
+            0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x00,
+            0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80,
+            0x90, 0xa0, 0xb0, 0xc0, 0xd0, 0xe0, 0xf0, 0x01,
+            0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+            0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x1a, 0x1b,
+            0x1c, 0x1d, 0x1e, 0x1f, 0x2a, 0x2b, 0x2c, 0x2d
+        };
+    }
+    return publicKey;
+}
+
+// Keys derived per streaming batch; bounds the memory held per stage to a few MiB.
+constexpr size_t STREAM_BATCH = 1 << 16;
+// read() buffer for hex-line input; holds roughly one batch of 130-character lines.
+constexpr size_t STREAM_READ_SIZE = 8 << 20;
+
+// Write the whole buffer, retrying short and interrupted writes.
+static bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Derives, formats and writes batches of addresses in input order. Output of batch k is
+// written in the background while batch k + 1 is derived, using two output buffers.
+class AddressStreamWriter {
+public:
+    // `cache` may be nullptr; otherwise repeated keys are served from it. With a `watchlist`
+    // only watched addresses are written (see writeMatches).
+    AddressStreamWriter(int fd, bool rawOutput, eth::ThreadPool& pool, eth::AddressCache* cache = nullptr,
+                        const eth::Watchlist* watchlist = nullptr)
+        : fd_(fd), rawOutput_(rawOutput), pool_(pool), cache_(cache), watchlist_(watchlist) {}
+
+    ~AddressStreamWriter() { finish(); }
+
+    // Derive and queue one batch. `records` follow the deriveAddresses layout (key in the
+    // last 64 bytes of each record); `valid` may be nullptr when every record is valid.
+    // Invalid records produce an "invalid" text line, or 20 zero bytes in raw mode.
+    void write(const eth::Byte* records, size_t stride, size_t count, const uint8_t* valid) {
+        std::vector<char>& out = output_[current_];
+        if (watchlist_) {
+            writeMatches(records, stride, count, valid, out);
         } else {
-            std::cout << "No public key provided. Using default test data.\n";
-            publicKey = {
-                0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0,
-                0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88,
-                0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x00,
-                0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80,
-                0x90, 0xa0, 0xb0, 0xc0, 0xd0, 0xe0, 0xf0, 0x01,
-                0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
-                0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x1a, 0x1b,
-                0x1c, 0x1d, 0x1e, 0x1f, 0x2a, 0x2b, 0x2c, 0x2d
-            };
-        }
-        return publicKey;
-    }
-
-    /**
-     * @brief Derive multiple Ethereum addresses in parallel.
-     * @param publicKeys Vector of public keys.
-     * @param addresses Vector of buffers to store the resulting addresses (each must be 43 bytes).
-     * @throws std::runtime_error if the number of public keys and address buffers do not match.
-     */
-    inline void deriveMultipleAddresses(const std::vector<std::vector<Byte>>& publicKeys,
-                                          std::vector<std::array<char, 43>>& addresses) {
-        if (publicKeys.size() != addresses.size()) {
-            throw std::runtime_error("Number of public keys and address buffers must match.");
-        }
-        const size_t numKeys = publicKeys.size();
-        std::atomic<size_t> index{0};
-        const size_t numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
-        std::vector<std::thread> threads;
-        threads.reserve(numThreads);
-        auto worker = [&]() {
-            CryptoPP::Keccak_256 keccak;
-            while (true) {
-                size_t i = index.fetch_add(1, std::memory_order_relaxed);
-                if (i >= numKeys)
-                    break;
-                deriveEthereumAddress(publicKeys[i], addresses[i].data(), keccak);
+            writeAddresses(records, stride, count, valid, out);
+        }
+        records_ += count;
+
+        if (pending_.valid() && !pending_.get()) {
+            ok_ = false;
+        }
+        if (ok_) {
+            pending_ = std::async(std::launch::async, writeAll, fd_, out.data(), out.size());
+        }
+        current_ ^= 1;
+    }
+
+    // Wait for the last write; returns false if any write failed.
+    bool finish() {
+        if (pending_.valid() && !pending_.get()) {
+            ok_ = false;
+        }
+        return ok_;
+    }
+
+    size_t records() const noexcept { return records_; }
+    size_t invalid() const noexcept { return invalid_; }
+    size_t matches() const noexcept { return matches_; }
+
+private:
+    // One line (or 20 raw bytes) per record.
+    void writeAddresses(const eth::Byte* records, size_t stride, size_t count, const uint8_t* valid,
+                        std::vector<char>& out) {
+        addresses_.resize(count);
+        if (cache_ && !rawOutput_) {
+            // The cache holds the checksummed text too, so derive and format in one pass.
+            out.resize(count * 43);
+            eth::deriveChecksummedAddresses(records, stride, count, addresses_.data()->data(),
+                                            reinterpret_cast<eth::AddressString*>(out.data()), *cache_, pool_,
+                                            valid);
+        } else if (cache_) {
+            eth::deriveAddresses(records, stride, count, addresses_.data()->data(), *cache_, pool_, valid);
+        } else {
+            eth::deriveAddresses(records, stride, count, addresses_.data()->data(), pool_);
+        }
+
+        if (rawOutput_) {
+            out.resize(count * 20);
+            std::memcpy(out.data(), addresses_.data(), out.size());
+            for (size_t i = 0; valid && i < count; ++i) {
+                if (!valid[i]) {
+                    std::memset(out.data() + i * 20, 0, 20);
+                    ++invalid_;
+                }
             }
-        };
-        for (size_t t = 0; t < numThreads; ++t) {
-            threads.emplace_back(worker);
+        } else {
+            if (!cache_) {
+                out.resize(count * 43);
+                auto* lines = reinterpret_cast<eth::AddressString*>(out.data());
+                eth::formatAddresses(std::span<const eth::Address>(addresses_.data(), count),
+                                     std::span<eth::AddressString>(lines, count), true, pool_);
+            }
+            // Turn the NUL-terminated strings into newline-terminated lines, compacting
+            // around the shorter "invalid" lines when there are any.
+            size_t at = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (valid && !valid[i]) {
+                    std::memcpy(out.data() + at, "invalid\n", 8);
+                    at += 8;
+                    ++invalid_;
+                    continue;
+                }
+                std::memmove(out.data() + at, out.data() + i * 43, 42);
+                out[at + 42] = '\n';
+                at += 43;
+            }
+            out.resize(at);
+        }
+    }
+
+    // Keep only watched addresses: "<record> <EIP-55 address>" lines, or in raw mode the record
+    // number as 8 little-endian bytes followed by the 20-byte address. Records are numbered from
+    // 0 across the whole stream. Only the matches are checksummed; invalid records never match.
+    // Matching runs on the workers, one chunk at a time through the prefetching matchBatch:
+    // uncached, each chunk is matched right after it is derived, while it is still in cache.
+    void writeMatches(const eth::Byte* records, size_t stride, size_t count, const uint8_t* valid,
+                      std::vector<char>& out) {
+        found_.clear();
+        if (cache_) {
+            addresses_.resize(count);
+            eth::deriveAddresses(records, stride, count, addresses_.data()->data(), *cache_, pool_, valid);
+            eth::findWatchedAddresses(std::span<const eth::Address>(addresses_.data(), count), *watchlist_,
+                                      found_, pool_);
+        } else {
+            eth::findWatchedAddresses(records, stride, count, *watchlist_, found_, pool_);
+        }
+        out.clear();
+        for (size_t i = 0; valid && i < count; ++i) {
+            invalid_ += !valid[i];
+        }
+        for (const eth::WatchlistMatch& match : found_) {
+            const size_t i = match.index;
+            if (valid && !valid[i]) {
+                continue;
+            }
+            const uint64_t record = records_ + i;
+            if (rawOutput_) {
+                for (unsigned b = 0; b < 8; ++b) {
+                    out.push_back(static_cast<char>(record >> (8 * b)));
+                }
+                out.insert(out.end(), match.address.data(), match.address.data() + 20);
+            } else {
+                const std::string number = std::to_string(record);
+                char text[43];
+                match.address.toChecksumHex(text);
+                out.insert(out.end(), number.begin(), number.end());
+                out.push_back(' ');
+                out.insert(out.end(), text, text + 42);
+                out.push_back('\n');
+            }
+            ++matches_;
+        }
+    }
+
+    int fd_;
+    bool rawOutput_;
+    eth::ThreadPool& pool_;
+    eth::AddressCache* cache_;
+    const eth::Watchlist* watchlist_;
+    std::vector<eth::Address> addresses_;
+    std::vector<eth::WatchlistMatch> found_;
+    std::vector<char> output_[2];
+    size_t current_ = 0;
+    std::future<bool> pending_;
+    bool ok_ = true;
+    size_t records_ = 0;
+    size_t invalid_ = 0;
+    size_t matches_ = 0;
+};
+
+// Flags 65-byte records whose first byte is not the 0x04 uncompressed-point prefix.
+static const uint8_t* checkPrefixes(const eth::Byte* records, size_t recordSize, size_t count,
+                                    std::vector<uint8_t>& valid) {
+    if (recordSize != 65) {
+        return nullptr;
+    }
+    valid.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        valid[i] = records[i * recordSize] == 0x04;
+    }
+    return valid.data();
+}
+
+// Binary records from a regular file, read in place through a read-only mapping.
+// Returns false if the file cannot be mapped, so the caller can fall back to read().
+static bool streamMappedRecords(int fd, size_t size, size_t recordSize, AddressStreamWriter& writer) {
+    if (size == 0) {
+        return true;
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    const auto* records = static_cast<const eth::Byte*>(mapping);
+    const size_t count = size / recordSize;
+    std::vector<uint8_t> valid;
+    for (size_t first = 0; first < count; first += STREAM_BATCH) {
+        const size_t n = std::min(STREAM_BATCH, count - first);
+        const eth::Byte* batch = records + first * recordSize;
+        writer.write(batch, recordSize, n, checkPrefixes(batch, recordSize, n, valid));
+    }
+    munmap(mapping, size);
+    if (size % recordSize != 0) {
+        std::cerr << "Warning: ignoring " << size % recordSize << " trailing bytes (incomplete record)\n";
+    }
+    return true;
+}
+
+// Binary records from any readable descriptor, one batch-sized read buffer at a time.
+static bool streamReadRecords(int fd, size_t recordSize, AddressStreamWriter& writer) {
+    std::vector<eth::Byte> buffer(STREAM_BATCH * recordSize);
+    std::vector<uint8_t> valid;
+    bool eof = false;
+    while (!eof) {
+        size_t filled = 0;
+        while (filled < buffer.size()) {
+            ssize_t n = read(fd, buffer.data() + filled, buffer.size() - filled);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                return false;
+            }
+            if (n == 0) {
+                eof = true;
+                break;
+            }
+            filled += static_cast<size_t>(n);
         }
-        for (auto& t : threads) {
-            t.join();
+        const size_t count = filled / recordSize;
+        if (count > 0) {
+            writer.write(buffer.data(), recordSize, count, checkPrefixes(buffer.data(), recordSize, count, valid));
         }
+        if (eof && filled % recordSize != 0) {
+            std::cerr << "Warning: ignoring " << filled % recordSize << " trailing bytes (incomplete record)\n";
+        }
+    }
+    return true;
+}
+
+// Decode one hex line: 128 digits, or 130 starting with the "04" prefix, optionally "0x"-prefixed.
+static bool parseKeyLine(std::string_view line, eth::Byte* key) noexcept {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    if (line.size() >= 2 && line[0] == '0' && (line[1] == 'x' || line[1] == 'X')) {
+        line.remove_prefix(2);
+    }
+    if (line.size() == 130 && line[0] == '0' && line[1] == '4') {
+        line.remove_prefix(2);
+    }
+    return line.size() == 128 && eth::hexDecode(line.data(), line.size(), key);
+}
+
+// Newline-delimited hex keys. Lines are split on the calling thread and decoded on the pool.
+static bool streamHexLines(int fd, AddressStreamWriter& writer, eth::ThreadPool& pool) {
+    std::vector<char> buffer(STREAM_READ_SIZE);
+    std::vector<std::string_view> lines;
+    std::vector<eth::PublicKeyBytes> keys(STREAM_BATCH);
+    std::vector<uint8_t> valid(STREAM_BATCH);
+    auto flush = [&] {
+        pool.parallelFor(lines.size(), 1024, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                valid[i] = parseKeyLine(lines[i], keys[i].data());
+            }
+        });
+        writer.write(keys.data()->data(), sizeof(eth::PublicKeyBytes), lines.size(), valid.data());
+        lines.clear();
+    };
+
+    size_t filled = 0;
+    bool eof = false;
+    bool skipping = false; // discarding the rest of an over-long line
+    while (!eof) {
+        ssize_t n = read(fd, buffer.data() + filled, buffer.size() - filled);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return false;
+        }
+        eof = (n == 0);
+        filled += static_cast<size_t>(n);
+        if (!eof && filled < buffer.size()) {
+            continue;
+        }
+
+        size_t begin = 0;
+        if (skipping) {
+            const char* newline = static_cast<const char*>(std::memchr(buffer.data(), '\n', filled));
+            if (!newline) {
+                filled = 0;
+                continue;
+            }
+            begin = static_cast<size_t>(newline - buffer.data()) + 1;
+            skipping = false;
+        }
+        size_t end = filled;
+        if (!eof) {
+            while (end > begin && buffer[end - 1] != '\n') {
+                --end;
+            }
+            if (end == begin) {
+                // One line fills the whole buffer: report it once and drop the remainder.
+                lines.emplace_back();
+                flush();
+                skipping = true;
+                filled = 0;
+                continue;
+            }
+        }
+        for (const char* cursor = buffer.data() + begin; cursor < buffer.data() + end;) {
+            const size_t left = static_cast<size_t>(buffer.data() + end - cursor);
+            const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', left));
+            const char* lineEnd = newline ? newline : cursor + left;
+            lines.emplace_back(cursor, static_cast<size_t>(lineEnd - cursor));
+            cursor = newline ? newline + 1 : lineEnd;
+            if (lines.size() == STREAM_BATCH) {
+                flush();
+            }
+        }
+        if (!lines.empty()) {
+            flush();
+        }
+        std::memmove(buffer.data(), buffer.data() + end, filled - end);
+        filled -= end;
+    }
+    return true;
+}
+
+/**
+ * Streaming mode: derive an address for every public key in a file (or stdin for "-").
+ * recordSize 0 reads hex lines; 64 or 65 reads packed binary records (65-byte records
+ * carry the 0x04 prefix). Regular binary files are memory-mapped. Results are written
+ * to stdout in input order, as EIP-55 lines or packed 20-byte records. `cache` may be
+ * nullptr; its hit/miss counters are reported with the throughput. With a `watchlist`
+ * only the watched addresses are written, tagged with their record numbers.
+ */
+static bool streamAddresses(std::string_view path, size_t recordSize, bool rawOutput, eth::AddressCache* cache,
+                            const eth::Watchlist* watchlist) {
+    const bool isStdin = (path == "-");
+    int fd = isStdin ? STDIN_FILENO : open(std::string(path).c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: cannot open " << path << ": " << std::strerror(errno) << '\n';
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    auto start = std::chrono::steady_clock::now();
+    eth::ThreadPool& pool = eth::ThreadPool::shared();
+    AddressStreamWriter writer(STDOUT_FILENO, rawOutput, pool, cache, watchlist);
+
+    bool readOk;
+    struct stat info{};
+    if (recordSize == 0) {
+        readOk = streamHexLines(fd, writer, pool);
+    } else if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) &&
+               streamMappedRecords(fd, static_cast<size_t>(info.st_size), recordSize, writer)) {
+        readOk = true;
+    } else {
+        readOk = streamReadRecords(fd, recordSize, writer);
+    }
+    const int readError = errno;
+    const bool writeOk = writer.finish();
+    if (!isStdin) {
+        close(fd);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << path << ": " << writer.records() << " keys in " << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << " (" << static_cast<size_t>(static_cast<double>(writer.records()) / seconds) << " keys/s)";
+    }
+    if (writer.invalid() > 0) {
+        std::cerr << ", " << writer.invalid() << " invalid keys";
+    }
+    std::cerr << '\n';
+    if (cache) {
+        const eth::AddressCacheStats stats = cache->stats();
+        std::cerr << "cache: " << stats.hits << " hits, " << stats.misses << " misses ("
+                  << 100.0 * stats.hitRate() << "% hit rate), " << stats.evictions << " evictions, "
+                  << cache->capacity() << " entries\n";
+    }
+    if (watchlist) {
+        std::cerr << "watchlist: " << writer.matches() << " matches against " << watchlist->size()
+                  << " addresses\n";
+    }
+    if (!readOk) {
+        std::cerr << "Error: failed reading " << path << ": " << std::strerror(readError) << '\n';
+    }
+    if (!writeOk) {
+        std::cerr << "Error: failed writing output\n";
+    }
+    return readOk && writeOk && writer.invalid() == 0;
+}
+
+// Load a watchlist of hex address lines, or of packed 20-byte records when `binary` is set.
+static std::unique_ptr<eth::Watchlist> loadWatchlist(const char* path, bool binary) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error(std::string("cannot open watchlist ") + path);
+    }
+    const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (binary) {
+        return std::make_unique<eth::Watchlist>(
+            eth::Watchlist::fromBinary(reinterpret_cast<const eth::Byte*>(data.data()), data.size()));
     }
+    return std::make_unique<eth::Watchlist>(eth::Watchlist::fromHexLines(data));
+}
 
-} // namespace eth
+// Write the metrics report requested with --metrics, if any; returns `status`, or 1 if writing failed.
+static int finishMetrics(const char* path, int status) {
+    if (path && !metrics::writeReportFile(path)) {
+        std::cerr << "Error: cannot write metrics to " << path << '\n';
+        return 1;
+    }
+    return status;
+}
+
+static int runUtility(int argc, char* argv[]);
 
 int main(int argc, char* argv[]) {
+    // --metrics <file> (any mode): record stage latencies and worker load, then write them to
+    // <file> on exit, as JSON for "*.json" and in Prometheus text format otherwise.
+    const char* metricsPath = nullptr;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--metrics" && i + 1 < argc) {
+            metricsPath = argv[++i];
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    if (metricsPath) {
+        metrics::setEnabled(true);
+    }
+    return finishMetrics(metricsPath, runUtility(kept, argv));
+}
+
+static int runUtility(int argc, char* argv[]) {
+    // Report the CPU features and SIMD kernels this binary selected (see KECCAK_CPU_LEVEL).
+    if (argc == 2 && std::string_view(argv[1]) == "--cpu-info") {
+        cpu::writeReport(std::cout);
+        std::cout << '\n';
+        return 0;
+    }
+
+    // Streaming mode: keccak_public_key_utility --stream [--binary|--binary65] [--raw] [--cache <entries>]
+    //                   [--watch <file>|--watch-binary <file>] [file|-]
+    // --watch loads hex address lines, --watch-binary packed 20-byte addresses; only matches are written.
+    if (argc > 1 && std::string_view(argv[1]) == "--stream") {
+        size_t recordSize = 0;
+        bool rawOutput = false;
+        size_t cacheEntries = 0;
+        const char* watchPath = nullptr;
+        bool watchBinary = false;
+        std::string_view path = "-";
+        for (int i = 2; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg == "--cache" && i + 1 < argc) {
+                const std::string_view value = argv[++i];
+                const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), cacheEntries);
+                if (error != std::errc() || end != value.data() + value.size()) {
+                    std::cerr << "Error: invalid value for " << arg << ": " << value << '\n';
+                    return 1;
+                }
+            } else if ((arg == "--watch" || arg == "--watch-binary") && i + 1 < argc) {
+                watchBinary = (arg == "--watch-binary");
+                watchPath = argv[++i];
+            } else if (arg == "--cache" || arg == "--watch" || arg == "--watch-binary") {
+                std::cerr << "Error: missing value for " << arg << '\n';
+                return 1;
+            } else if (arg == "--binary") {
+                recordSize = 64;
+            } else if (arg == "--binary65") {
+                recordSize = 65;
+            } else if (arg == "--raw") {
+                rawOutput = true;
+            } else if (arg.starts_with("--")) {
+                // Never treat a mistyped or misplaced option as a file name.
+                std::cerr << "Error: unknown option: " << arg << '\n';
+                return 1;
+            } else {
+                path = arg;
+            }
+        }
+        try {
+            std::unique_ptr<eth::AddressCache> cache;
+            if (cacheEntries > 0) {
+                cache = std::make_unique<eth::AddressCache>(cacheEntries);
+            }
+            std::unique_ptr<eth::Watchlist> watchlist;
+            if (watchPath) {
+                watchlist = loadWatchlist(watchPath, watchBinary);
+            }
+            return streamAddresses(path, recordSize, rawOutput, cache.get(), watchlist.get()) ? 0 : 1;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+
     try {
         // Example: Derive a single address
-        auto publicKey = eth::parsePublicKey(argc, argv);
-        char addressBuffer[43];
-        CryptoPP::Keccak_256 keccak;
-        eth::deriveEthereumAddress(publicKey, addressBuffer, keccak);
-        std::cout << "Derived Ethereum address: " << addressBuffer << '\n';
+        auto publicKey = parsePublicKey(argc, argv);
+        // The text overload caches the EIP-55 string along with the address.
+        eth::AddressCache cache(1024);
+        char address[43];
+        eth::deriveEthereumAddress(publicKey, address, cache);
+        std::cout << "Derived Ethereum address: " << address << '\n';
 
         // Example: Derive multiple addresses in parallel.
-        // For demonstration, we duplicate the same public key.
+        // For demonstration, we duplicate the same public key; both are served from the cache.
         std::vector<std::vector<eth::Byte>> publicKeys = { publicKey, publicKey };
         std::vector<std::array<char, 43>> addresses(publicKeys.size());
-        eth::deriveMultipleAddresses(publicKeys, addresses);
+        eth::deriveMultipleAddresses(publicKeys, addresses, cache, eth::ThreadPool::shared());
         for (const auto& addr : addresses) {
             std::cout << "Derived Ethereum address (parallel): " << addr.data() << '\n';
         }
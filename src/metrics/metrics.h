@@ -0,0 +1,443 @@
+// metrics.h - Opt-in hot-path instrumentation: per-stage latency histograms and worker load
+//
+// Recording is off by default. When off, every probe is one relaxed load of a
+// global flag and a predictable branch, so the probes stay compiled into
+// production builds. Turn it on with
+//
+//   KECCAK_METRICS=1        (environment, read once at start-up), or
+//   metrics::setEnabled(true)
+//
+// and defining ETH_DISABLE_METRICS removes the probes at compile time.
+//
+// Each thread records into its own block of counters and log-linear (HDR-style)
+// histograms, so recording takes no locks and shares no cache lines; blocks are
+// merged only when a report is written. Thread pools additionally register one
+// counter set per worker (items, chunks, busy and idle time) to expose imbalance.
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace metrics {
+
+    // Instrumented stages of address derivation.
+    enum class Stage : uint8_t {
+        PublicKeyHash = 0, // Keccak-256 of one public key
+        HexEncode,         // raw address -> 40 hex digits
+        ChecksumHash,      // EIP-55 hash and case fix-up of one address
+        BatchKeyHash,      // multi-buffer Keccak-256 of a chunk of keys
+        BatchChecksum,     // multi-buffer EIP-55 formatting of a chunk of addresses
+        Count
+    };
+
+    inline constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::Count);
+
+    inline const char* stageName(Stage stage) noexcept {
+        switch (stage) {
+            case Stage::PublicKeyHash: return "public_key_hash";
+            case Stage::HexEncode: return "hex_encode";
+            case Stage::ChecksumHash: return "checksum_hash";
+            case Stage::BatchKeyHash: return "batch_key_hash";
+            case Stage::BatchChecksum: return "batch_checksum";
+            case Stage::Count: break;
+        }
+        return "unknown";
+    }
+
+    namespace detail {
+
+        inline constexpr const char* ENABLE_ENV = "KECCAK_METRICS";
+
+        // Histogram layout: values below 16 ns get exact buckets; above that each power
+        // of two is split into 16 linear sub-buckets (at most 6.25% relative error).
+        inline constexpr unsigned SUB_BUCKET_BITS = 4;
+        inline constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+        inline constexpr size_t BUCKETS = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+        constexpr size_t bucketIndex(uint64_t ns) noexcept {
+            if (ns < SUB_BUCKETS) {
+                return static_cast<size_t>(ns);
+            }
+            const unsigned shift = static_cast<unsigned>(std::bit_width(ns)) - (SUB_BUCKET_BITS + 1);
+            return SUB_BUCKETS + shift * SUB_BUCKETS + static_cast<size_t>((ns >> shift) - SUB_BUCKETS);
+        }
+
+        // Largest value that falls into bucket `index`.
+        constexpr uint64_t bucketUpperBound(size_t index) noexcept {
+            if (index < SUB_BUCKETS) {
+                return index;
+            }
+            const size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+            const uint64_t sub = SUB_BUCKETS + (index - SUB_BUCKETS) % SUB_BUCKETS;
+            return ((sub + 1) << shift) - 1;
+        }
+
+        static_assert(bucketIndex(~uint64_t(0)) == BUCKETS - 1, "histogram must cover 64-bit values");
+
+        // Prometheus export ladder: le = 2^k - 1 ns for k in [MIN, MAX] (15 ns .. ~68.7 s).
+        // Every such value is the last one of a histogram bucket, so the exported cumulative
+        // counts are exact, and the ladder is the same on every scrape.
+        inline constexpr unsigned PROMETHEUS_MIN_BITS = SUB_BUCKET_BITS;
+        inline constexpr unsigned PROMETHEUS_MAX_BITS = 36;
+
+        static_assert(bucketUpperBound(bucketIndex((uint64_t(1) << PROMETHEUS_MAX_BITS) - 1)) ==
+                          (uint64_t(1) << PROMETHEUS_MAX_BITS) - 1,
+                      "export bounds must fall on histogram bucket boundaries");
+
+        // Exact decimal seconds for a nanosecond count ("0.000001023", "68.719476735").
+        inline std::string formatSeconds(uint64_t ns) {
+            std::string text = std::to_string(ns / 1000000000) + '.';
+            const std::string fraction = std::to_string(ns % 1000000000);
+            text.append(9 - fraction.size(), '0');
+            text += fraction;
+            while (text.back() == '0') {
+                text.pop_back();
+            }
+            if (text.back() == '.') {
+                text.pop_back();
+            }
+            return text;
+        }
+
+        // Single-writer counter: only the owning thread adds, readers may load concurrently.
+        inline void add(std::atomic<uint64_t>& counter, uint64_t value) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        struct StageData {
+            std::atomic<uint64_t> calls{0};
+            std::atomic<uint64_t> items{0};
+            std::atomic<uint64_t> totalNs{0};
+            std::atomic<uint64_t> maxNs{0};
+            std::atomic<uint64_t> buckets[BUCKETS] = {};
+        };
+
+        struct alignas(64) ThreadData {
+            StageData stages[STAGE_COUNT];
+        };
+
+        inline bool envEnabled() noexcept {
+            const char* value = std::getenv(ENABLE_ENV);
+            return value && *value && std::string_view(value) != "0";
+        }
+
+        // A namespace-scope flag (not a function-local static), so enabled() has no guard check.
+        inline std::atomic<bool> enabledFlag{ envEnabled() };
+
+    } // namespace detail
+
+    // Per-worker counters of one thread pool.
+    struct alignas(64) WorkerCounters {
+        std::atomic<uint64_t> items{0};   // indices processed
+        std::atomic<uint64_t> chunks{0};  // chunks executed
+        std::atomic<uint64_t> busyNs{0};  // time spent running chunks
+        std::atomic<uint64_t> idleNs{0};  // time without work while its batch was still running
+        std::atomic<uint64_t> runBusyNs{0}; // busy time in the current batch (pool bookkeeping)
+    };
+
+    struct WorkerGroup {
+        std::string name;
+        size_t size = 0;
+        std::unique_ptr<WorkerCounters[]> workers;
+    };
+
+    namespace detail {
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadData>> threads;
+            std::vector<ThreadData*> retired; // blocks of exited threads, reused (counts kept)
+            std::vector<std::shared_ptr<WorkerGroup>> groups;
+        };
+
+        inline Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        // Returns the calling thread's block to the registry when the thread exits.
+        struct ThreadHandle {
+            ThreadData* data = nullptr;
+            ~ThreadHandle() {
+                if (data) {
+                    Registry& r = registry();
+                    std::lock_guard<std::mutex> lock(r.mutex);
+                    r.retired.push_back(data);
+                }
+            }
+        };
+
+        inline ThreadData& threadData() {
+            thread_local ThreadHandle handle;
+            if (!handle.data) {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                if (!r.retired.empty()) {
+                    handle.data = r.retired.back();
+                    r.retired.pop_back();
+                } else {
+                    r.threads.push_back(std::make_unique<ThreadData>());
+                    handle.data = r.threads.back().get();
+                }
+            }
+            return *handle.data;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Whether probes record anything.
+     */
+    inline bool enabled() noexcept {
+#if defined(ETH_DISABLE_METRICS)
+        return false;
+#else
+        return detail::enabledFlag.load(std::memory_order_relaxed);
+#endif
+    }
+
+    // Start or stop recording; data already recorded is kept.
+    inline void setEnabled(bool on) noexcept {
+        detail::enabledFlag.store(on, std::memory_order_relaxed);
+    }
+
+    inline uint64_t nowNs() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief Record one call of a stage on the calling thread.
+     * @param ns Duration of the call.
+     * @param items Work items the call covered (keys in a chunk, for batch stages).
+     */
+    inline void record(Stage stage, uint64_t ns, uint64_t items = 1) {
+        detail::StageData& s = detail::threadData().stages[static_cast<size_t>(stage)];
+        detail::add(s.calls, 1);
+        detail::add(s.items, items);
+        detail::add(s.totalNs, ns);
+        if (ns > s.maxNs.load(std::memory_order_relaxed)) {
+            s.maxNs.store(ns, std::memory_order_relaxed);
+        }
+        detail::add(s.buckets[detail::bucketIndex(ns)], 1);
+    }
+
+    /**
+     * @brief Times the enclosing scope as one call of a stage, when recording is enabled.
+     */
+    class StageTimer {
+    public:
+        explicit StageTimer(Stage stage, uint64_t items = 1) noexcept
+            : start_(enabled() ? nowNs() : 0), items_(items), stage_(stage) {}
+
+        ~StageTimer() {
+            if (start_) {
+                record(stage_, nowNs() - start_, items_);
+            }
+        }
+
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+    private:
+        uint64_t start_;
+        uint64_t items_;
+        Stage stage_;
+    };
+
+    /**
+     * @brief Register per-worker counters for a thread pool.
+     * @note The registry keeps the group alive, so its totals are still reported after
+     *       the pool is destroyed.
+     */
+    inline std::shared_ptr<WorkerGroup> registerWorkerGroup(size_t workers) {
+        detail::Registry& r = detail::registry();
+        auto group = std::make_shared<WorkerGroup>();
+        group->size = workers;
+        group->workers = std::make_unique<WorkerCounters[]>(workers);
+        std::lock_guard<std::mutex> lock(r.mutex);
+        group->name = "pool" + std::to_string(r.groups.size());
+        r.groups.push_back(group);
+        return group;
+    }
+
+    // Merged view of one stage across all threads.
+    struct StageSummary {
+        uint64_t calls = 0;
+        uint64_t items = 0;
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+        std::vector<uint64_t> buckets = std::vector<uint64_t>(detail::BUCKETS);
+
+        // Upper bound of the bucket holding quantile q (0..1), in nanoseconds.
+        uint64_t quantileNs(double q) const noexcept {
+            if (calls == 0) {
+                return 0;
+            }
+            const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(calls) + 0.5));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                seen += buckets[i];
+                if (seen >= rank) {
+                    return std::min(detail::bucketUpperBound(i), maxNs);
+                }
+            }
+            return maxNs;
+        }
+    };
+
+    /**
+     * @brief Merge every thread's data for one stage.
+     */
+    inline StageSummary summarize(Stage stage) {
+        StageSummary out;
+        detail::Registry& r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (const auto& thread : r.threads) {
+            const detail::StageData& s = thread->stages[static_cast<size_t>(stage)];
+            out.calls += s.calls.load(std::memory_order_relaxed);
+            out.items += s.items.load(std::memory_order_relaxed);
+            out.totalNs += s.totalNs.load(std::memory_order_relaxed);
+            out.maxNs = std::max(out.maxNs, s.maxNs.load(std::memory_order_relaxed));
+            for (size_t i = 0; i < detail::BUCKETS; ++i) {
+                out.buckets[i] += s.buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Write stage summaries (with non-empty histogram buckets) and worker counters as JSON.
+     */
+    inline void writeJson(std::ostream& out) {
+        out << "{\"enabled\": " << (enabled() ? "true" : "false") << ", \"stages\": {";
+        for (size_t st = 0; st < STAGE_COUNT; ++st) {
+            const Stage stage = static_cast<Stage>(st);
+            const StageSummary s = summarize(stage);
+            out << (st ? ", " : "") << '"' << stageName(stage) << "\": {\"calls\": " << s.calls
+                << ", \"items\": " << s.items << ", \"total_ns\": " << s.totalNs << ", \"max_ns\": " << s.maxNs
+                << ", \"p50_ns\": " << s.quantileNs(0.50) << ", \"p90_ns\": " << s.quantileNs(0.90)
+                << ", \"p99_ns\": " << s.quantileNs(0.99) << ", \"p999_ns\": " << s.quantileNs(0.999)
+                << ", \"buckets\": [";
+            bool first = true;
+            for (size_t i = 0; i < s.buckets.size(); ++i) {
+                if (s.buckets[i]) {
+                    out << (first ? "" : ", ") << '[' << detail::bucketUpperBound(i) << ", " << s.buckets[i] << ']';
+                    first = false;
+                }
+            }
+            out << "]}";
+        }
+        out << "}, \"workers\": {";
+        detail::Registry& r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (size_t g = 0; g < r.groups.size(); ++g) {
+            const WorkerGroup& group = *r.groups[g];
+            out << (g ? ", " : "") << '"' << group.name << "\": [";
+            for (size_t w = 0; w < group.size; ++w) {
+                const WorkerCounters& c = group.workers[w];
+                out << (w ? ", " : "") << "{\"items\": " << c.items.load(std::memory_order_relaxed)
+                    << ", \"chunks\": " << c.chunks.load(std::memory_order_relaxed)
+                    << ", \"busy_ns\": " << c.busyNs.load(std::memory_order_relaxed)
+                    << ", \"idle_ns\": " << c.idleNs.load(std::memory_order_relaxed) << '}';
+            }
+            out << ']';
+        }
+        out << "}}";
+    }
+
+    /**
+     * @brief Write the same data in the Prometheus text exposition format.
+     * @note Stage histograms are exported in seconds with the full fixed ladder of cumulative
+     *       buckets (see PROMETHEUS_MIN_BITS), empty or not, ending with +Inf.
+     */
+    inline void writePrometheus(std::ostream& out) {
+        out << "# TYPE eth_stage_duration_seconds histogram\n";
+        for (size_t st = 0; st < STAGE_COUNT; ++st) {
+            const Stage stage = static_cast<Stage>(st);
+            const StageSummary s = summarize(stage);
+            const char* name = stageName(stage);
+            uint64_t cumulative = 0;
+            size_t next = 0;
+            for (unsigned bits = detail::PROMETHEUS_MIN_BITS; bits <= detail::PROMETHEUS_MAX_BITS; ++bits) {
+                const uint64_t bound = (uint64_t(1) << bits) - 1;
+                for (const size_t last = detail::bucketIndex(bound); next <= last; ++next) {
+                    cumulative += s.buckets[next];
+                }
+                out << "eth_stage_duration_seconds_bucket{stage=\"" << name << "\",le=\""
+                    << detail::formatSeconds(bound) << "\"} " << cumulative << '\n';
+            }
+            out << "eth_stage_duration_seconds_bucket{stage=\"" << name << "\",le=\"+Inf\"} " << s.calls << '\n'
+                << "eth_stage_duration_seconds_sum{stage=\"" << name << "\"} " << static_cast<double>(s.totalNs) * 1e-9 << '\n'
+                << "eth_stage_duration_seconds_count{stage=\"" << name << "\"} " << s.calls << '\n';
+        }
+        out << "# TYPE eth_stage_items_total counter\n";
+        for (size_t st = 0; st < STAGE_COUNT; ++st) {
+            const Stage stage = static_cast<Stage>(st);
+            out << "eth_stage_items_total{stage=\"" << stageName(stage) << "\"} " << summarize(stage).items << '\n';
+        }
+
+        detail::Registry& r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        const struct {
+            const char* metric;
+            std::atomic<uint64_t> WorkerCounters::*field;
+            double scale;
+        } workerMetrics[] = {
+            { "eth_worker_items_total", &WorkerCounters::items, 1.0 },
+            { "eth_worker_chunks_total", &WorkerCounters::chunks, 1.0 },
+            { "eth_worker_busy_seconds_total", &WorkerCounters::busyNs, 1e-9 },
+            { "eth_worker_idle_seconds_total", &WorkerCounters::idleNs, 1e-9 },
+        };
+        for (const auto& metric : workerMetrics) {
+            out << "# TYPE " << metric.metric << " counter\n";
+            for (const auto& group : r.groups) {
+                for (size_t w = 0; w < group->size; ++w) {
+                    const uint64_t value = (group->workers[w].*metric.field).load(std::memory_order_relaxed);
+                    out << metric.metric << "{pool=\"" << group->name << "\",worker=\"" << w << "\"} ";
+                    if (metric.scale == 1.0) {
+                        out << value;
+                    } else {
+                        out << static_cast<double>(value) * metric.scale;
+                    }
+                    out << '\n';
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Write a report to `path`: JSON if it ends in ".json", Prometheus text otherwise.
+     * @return false if the file cannot be written.
+     */
+    inline bool writeReportFile(const std::string& path) {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0) {
+            writeJson(file);
+            file << '\n';
+        } else {
+            writePrometheus(file);
+        }
+        return static_cast<bool>(file.flush());
+    }
+
+} // namespace metrics
+
+#endif // METRICS_H
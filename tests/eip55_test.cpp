@@ -0,0 +1,141 @@
+// Known-answer tests for EIP-55 checksums and public-key -> address derivation.
+//
+// Checksum vectors are the ones listed in EIP-55; the keys are the secp256k1 points
+// for private keys 1 and 2, whose addresses are widely published.
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../src/eth/address.h"
+#include "../src/eth/address_batch.h"
+#include "../src/eth/address_utils.h"
+#include "../src/eth/eip55.h"
+#include "test.h"
+
+namespace {
+
+    constexpr const char* CHECKSUMMED[] = {
+        // All caps
+        "0x52908400098527886E0F7030069857D2E4169EE7",
+        "0x8617E340B3D01FA5F11F306F4090FD50E238070D",
+        // All lower
+        "0xde709f2102306220921060314715629080e2fb77",
+        "0x27b1fdb04752bbc536007a920d24acb045561c26",
+        // Normal
+        "0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAed",
+        "0xfB6916095ca1df60bB79Ce92cE3Ea74c37c5d359",
+        "0xdbF03B407c01E7cD3CBea99509d93f8DDDC8C6FB",
+        "0xD1220A0cf47c7B9Be7A2E6BA89F429762e7b9aDb",
+    };
+    constexpr size_t VECTOR_COUNT = std::size(CHECKSUMMED);
+
+    struct KeyVector {
+        const char* publicKey; // 64-byte uncompressed key without the 0x04 prefix
+        const char* address;
+    };
+
+    constexpr KeyVector KEYS[] = {
+        { "79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798"
+          "483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8",
+          "0x7E5F4552091A69125d5DfCb7b8C2659029395Bdf" },
+        { "c6047f9441ed7d6d3045406e95c07cd85c778e4b8cef3ca7abac09b95c709ee5"
+          "1ae168fea63dc339a3c58419466ceaeef7f632653266d0e1236431a950cfe52a",
+          "0x2B5AD5c4795c026514f8317c7a215E218DcCD6cF" },
+    };
+
+    // Swap the case of the first letter, which must break the checksum.
+    std::string flipFirstLetter(std::string text) {
+        for (size_t i = 2; i < text.size(); ++i) {
+            if ((text[i] | 0x20) >= 'a' && (text[i] | 0x20) <= 'f') {
+                text[i] ^= 0x20;
+                break;
+            }
+        }
+        return text;
+    }
+
+    void checkSingle() {
+        for (const char* vector : CHECKSUMMED) {
+            eth::Address address;
+            CHECK(eth::Address::parse(vector, address));
+            CHECK_EQ_STR(std::string(address.checksummed().data(), 42), vector);
+            CHECK(eth::verifyEIP55(vector));
+            CHECK(!eth::verifyEIP55(flipFirstLetter(vector)));
+            CHECK(eth::verifyEIP55(std::string(vector).substr(2)));
+        }
+        eth::Address address;
+        CHECK(!eth::Address::parse("0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAe", address));
+        CHECK(!eth::Address::parse("0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAeg", address));
+        CHECK(!eth::verifyEIP55("0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAeg"));
+    }
+
+    // 11 addresses: one 8-way group plus a remainder, so both kernel paths run.
+    void checkBatch() {
+        constexpr size_t count = 11;
+        std::vector<eth::Byte> raw(20 * count);
+        std::vector<std::string> expected(count);
+        for (size_t i = 0; i < count; ++i) {
+            eth::Address address;
+            eth::Address::parse(CHECKSUMMED[i % VECTOR_COUNT], address);
+            std::memcpy(raw.data() + 20 * i, address.data(), 20);
+            expected[i] = CHECKSUMMED[i % VECTOR_COUNT];
+        }
+        std::vector<std::array<char, 43>> text(count);
+        eth::toEIP55Batch(raw.data(), count, text.data());
+        for (size_t i = 0; i < count; ++i) {
+            CHECK_EQ_STR(std::string(text[i].data()), expected[i]);
+        }
+
+        // 42-byte records; record 3 has one letter's case flipped.
+        std::string records;
+        for (size_t i = 0; i < count; ++i) {
+            records += i == 3 ? flipFirstLetter(expected[i]) : expected[i];
+        }
+        uint8_t results[count];
+        eth::verifyEIP55Batch(records.data(), 42, count, results);
+        for (size_t i = 0; i < count; ++i) {
+            CHECK(results[i] == (i == 3 ? 0 : 1));
+        }
+    }
+
+    void checkDerivation() {
+        for (const KeyVector& v : KEYS) {
+            const std::vector<uint8_t> key = test::fromHex(v.publicKey);
+            CHECK_EQ_STR(eth::deriveAddress(key.data()).toString(), v.address);
+
+            // Text straight from the derivation, fresh and then from the cache.
+            eth::AddressCache cache(16);
+            for (int pass = 0; pass < 2; ++pass) {
+                char text[43];
+                eth::deriveEthereumAddress(key, text, cache);
+                CHECK_EQ_STR(std::string(text), v.address);
+            }
+        }
+
+        // 65-byte records (0x04 prefix) through the strided batch API.
+        constexpr size_t count = 11;
+        std::vector<eth::Byte> records;
+        for (size_t i = 0; i < count; ++i) {
+            const std::vector<uint8_t> key = test::fromHex(KEYS[i % 2].publicKey);
+            records.push_back(0x04);
+            records.insert(records.end(), key.begin(), key.end());
+        }
+        std::vector<eth::Address> addresses(count);
+        eth::deriveAddresses(records.data(), 65, count, addresses.data()->data());
+        for (size_t i = 0; i < count; ++i) {
+            CHECK_EQ_STR(addresses[i].toString(), KEYS[i % 2].address);
+        }
+    }
+
+} // namespace
+
+int main() {
+    checkSingle();
+    checkBatch();
+    checkDerivation();
+    return test::summary("eip55_test");
+}
@@ -0,0 +1,113 @@
+// Known-answer tests for hex encoding/decoding and the per-character invalid-position mask.
+//
+// Lengths straddle the 32-character (SSSE3) and 64-character (AVX2) decode steps, and the
+// invalid characters sit right next to the valid ranges ('/', ':', '@', 'G', '`', 'g')
+// or outside ASCII, where range checks done with signed bytes go wrong.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../src/eth/hex.h"
+#include "test.h"
+
+namespace {
+
+    constexpr char INVALID[] = { '/', ':', '@', 'G', '`', 'g', ' ', '\0', '\x80', '\xff' };
+
+    bool isHexDigit(char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    void checkLiterals() {
+        const eth::Byte bytes[] = { 0x00, 0x1f, 0xab, 0xff, 0x90 };
+        char text[10];
+        eth::hexEncode(bytes, sizeof(bytes), text);
+        CHECK_EQ_STR(std::string(text, 10), "001fabff90");
+
+        eth::Byte out[4];
+        uint64_t mask[1] = {};
+        CHECK(eth::hexDecode("001FabFF", 8, out, mask));
+        CHECK(mask[0] == 0);
+        CHECK(test::toHex(out, 4) == "001fabff");
+
+        // Characters 4 and 5 are invalid.
+        mask[0] = 0;
+        CHECK(!eth::hexDecode("00ffzZ10", 8, out, mask));
+        CHECK(mask[0] == 0x30);
+
+        // A trailing unpaired character is reported invalid.
+        mask[0] = 0;
+        CHECK(!eth::hexDecode("abc", 3, out, mask));
+        CHECK(mask[0] == 0x4);
+    }
+
+    // Random-looking valid text with invalid characters planted every `step` positions,
+    // checked against a character-at-a-time reference mask.
+    void checkMasks() {
+        constexpr char digits[] = "0123456789abcdefABCDEF";
+        for (size_t length : { 2, 30, 31, 32, 34, 63, 64, 66, 127, 128, 130, 200, 257 }) {
+            for (size_t step : { 0, 1, 7, 13, 64 }) {
+                std::string text(length, '0');
+                for (size_t i = 0; i < length; ++i) {
+                    text[i] = digits[(i * 7 + length) % 22];
+                }
+                size_t planted = 0;
+                for (size_t i = 0; step != 0 && i < length; i += step) {
+                    text[i] = INVALID[planted++ % std::size(INVALID)];
+                }
+
+                std::vector<uint64_t> expected((length + 63) / 64);
+                for (size_t i = 0; i < length; ++i) {
+                    const bool unpaired = length % 2 != 0 && i == length - 1;
+                    if (!isHexDigit(text[i]) || unpaired) {
+                        expected[i / 64] |= uint64_t(1) << (i % 64);
+                    }
+                }
+                const bool expectValid =
+                    std::all_of(expected.begin(), expected.end(), [](uint64_t word) { return word == 0; });
+
+                std::vector<uint64_t> mask(expected.size());
+                std::vector<eth::Byte> out(length / 2);
+                const bool valid = eth::hexDecode(text.data(), length, out.data(), mask.data());
+                CHECK(valid == expectValid);
+                CHECK(mask == expected);
+
+                // Pairs made of two valid digits decode to their value.
+                for (size_t p = 0; p < length / 2; ++p) {
+                    if (isHexDigit(text[2 * p]) && isHexDigit(text[2 * p + 1])) {
+                        const std::vector<uint8_t> reference = test::fromHex(text.substr(2 * p, 2));
+                        CHECK(out[p] == reference[0]);
+                    }
+                }
+            }
+        }
+    }
+
+    void checkRoundTrip() {
+        std::vector<eth::Byte> bytes(300);
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            bytes[i] = static_cast<eth::Byte>(i * 37 + 11);
+        }
+        for (size_t length : { 0, 1, 15, 16, 17, 31, 32, 33, 64, 300 }) {
+            std::string text(2 * length, '\0');
+            eth::hexEncode(bytes.data(), length, text.data());
+            CHECK_EQ_STR(text, test::toHex(bytes.data(), length));
+            std::vector<eth::Byte> decoded(length);
+            CHECK(eth::hexDecode(text.data(), text.size(), decoded.data()));
+            CHECK(std::memcmp(decoded.data(), bytes.data(), length) == 0);
+        }
+    }
+
+} // namespace
+
+int main() {
+    checkLiterals();
+    checkMasks();
+    checkRoundTrip();
+    return test::summary("hex_test");
+}
@@ -0,0 +1,186 @@
+// Known-answer tests for Keccak-256, SHA3-* and SHAKE* around their rate boundaries.
+//
+// Message n is bytes i % 251 for i in [0, n); each algorithm is checked at 0, rate - 1,
+// rate, rate + 1 and 2 * rate bytes, where the padding lands at the end of a block, fills
+// a block of its own or follows a full block. Expected values come from pycryptodome.
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../src/keccak/keccak.h"
+#include "../src/keccak/keccak_multibuffer.h"
+#include "../src/keccak/sha3.h"
+#include "test.h"
+
+namespace {
+
+    struct Vector {
+        size_t length;
+        const char* expected;
+    };
+
+    std::vector<uint8_t> message(size_t length) {
+        std::vector<uint8_t> data(length);
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = static_cast<uint8_t>(i % 251);
+        }
+        return data;
+    }
+
+    constexpr Vector KECCAK256[] = {
+        { 0, "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470" },
+        { 135, "cbdfd9dee5faad3818d6b06f95a219fd290b0e1706f6a82e5a595b9ce9faca62" },
+        { 136, "7ce759f1ab7f9ce437719970c26b0a66ff11fe3e38e17df89cf5d29c7d7f807e" },
+        { 137, "ac73d4fae68b8453f764007c1a20ce95994187861f0c3227a3a8e99a73a3b1db" },
+        { 272, "8e2476e65823b24d96ebe239f2c1534cdf763e689e2410c3b1cb0c74e6177bfc" },
+    };
+
+    constexpr Vector SHA3_224[] = {
+        { 0, "6b4e03423667dbb73b6e15454f0eb1abd4597f9a1b078e3f5b5a6bc7" },
+        { 143, "64d0e8a1be3cf30ef6727b30a6e428f7f068d44634c943d277ad8e7f" },
+        { 144, "5be75e6a08f19913a1d8036c056cc4556b98dc90aeca3f2a0664dedc" },
+        { 145, "90b861ac1b1598459ad8337afa9933ce2f1a6f972c57daf8fc2737e4" },
+        { 288, "c31edb82e0debcac85099028f8dda66900e716217b7f30e003d611bc" },
+    };
+
+    constexpr Vector SHA3_256[] = {
+        { 0, "a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a" },
+        { 135, "fded8fd9d6551c601eeb3b7c6bc5e5cfd8aad1d015b7e9aaa9c9b9475231d5e2" },
+        { 136, "cf3ccff92480a29160c2d38317c430e14749bfee1788106957dfe73f8c4930e5" },
+        { 137, "ce9d7dc90913ee5d92745019479a5352c6d6279bef18ed07dc0a83ee8084daca" },
+        { 272, "b7ccd55b6c2c3fa144c9e0624059294975a348b02f321abe289701d3012f7794" },
+    };
+
+    constexpr Vector SHA3_384[] = {
+        { 0, "0c63a75b845e4f7d01107d852e4c2485c51a50aaaa94fc61995e71bbee983a2ac3713831264adb47fb6bd1e058d5f004" },
+        { 103, "1f91ee551ad18f268876d1fc262f137fe196580216c5193819a95ec5222537d2a658dd129c3d8080e65ec7460f1f4704" },
+        { 104, "5b8d0d5cf8b41be507be8fcbfcbdbac3a28eb368d430fed6780aaa78a93a8da4a6c50485949ca344f228be91a96005a3" },
+        { 105, "4a2f0a8f2f1f4cc4605cc2537e0be28cf8b465c30f0a54b494a7128ec54ee4e85706b5e47a5697344d15cbf85680cd40" },
+        { 208, "13a929eb9e4ac18a07de84b17e79bb420a86924b9dc4cd80038dd61f17770fc42460f2a0a717dd26fb6b6b4de357ae02" },
+    };
+
+    constexpr Vector SHA3_512[] = {
+        { 0, "a69f73cca23a9ac5c8b567dc185a756e97c982164fe25859e0d1dcc1475c80a6"
+             "15b2123af1f5f94c11e3e9402c3ac558f500199d95b6d3e301758586281dcd26" },
+        { 71, "3ccc850d53a1287af7b4560b2ef0d43eb5d9a80d62a0e9cf1dbc040135921104"
+              "d4395168e90bfc871773ebb34bca1bd67056e1cc7dc7a48ff7c3167d389f117c" },
+        { 72, "5d63f2bbe971a983ac6847480106e4e1264ee3a0befd79954914e1d86e795b2e"
+              "18238f12fc5e46cb9cc78efdec610a93647cc04e1c23d8caaa6a58c21dd26c07" },
+        { 73, "921d9b7b2b0f3066a1646dbb058c979cb3925dec0f8c269faaa7f9648e73465a"
+              "e55ec527257d5d5e1cfdbf5d6799bea1004b6186f5108c74e3b92fe924166558" },
+        { 144, "e1951b8bcb58ca75a34af80a7a2b765cad4257fe383a79b55bf21f180b75f6e5"
+               "b08f09598851eeea7d13486387618d6c6bf88cf23c0088a3f783f59a06d60493" },
+    };
+
+    // SHAKE: output bytes [rate - 16, rate + 16), which straddle the first squeeze permutation.
+    constexpr Vector SHAKE128[] = {
+        { 0, "167a580b14aabdefaee7eef47cb0fca9767be1fda69419dfb927e9df07348b19" },
+        { 167, "65b8ad00217c27e75b7d11c5214b731ed3fc45350ef44832dc463c1bddf33486" },
+        { 168, "fc0cbc09019d044e3a90e321231c3a61f4a0d48742c073be05223df144965cb2" },
+        { 169, "14fec88077e01f87c28944926abb73c38fa9579350f549a11966fd36750cba97" },
+        { 336, "c885ab51f97dd228e55ea216e0914cf402ab8009cf9fad37889a223e00972d88" },
+    };
+
+    constexpr Vector SHAKE256[] = {
+        { 0, "95522a6bcd16cf86f3d122109e3b1fdd943b6aec468a2d621a7c06c6a957c62b" },
+        { 135, "d587d1e63fea83b177a04230d041b8f96e77d6d9a7c142817cbf4cedfa17f386" },
+        { 136, "aae344dbe9a15fb155e4fa2ab7d7df09be06d83195c8892a2e6c5b56dadbb8f8" },
+        { 137, "dd012647abd1d899a03d1b514fb93828a21bc9368bc24fe63808d6be567248ba" },
+        { 272, "87c32b820a9462bbaf208c2303eac7f7d833d48ba3085241404ddc58edcba241" },
+    };
+
+    // One-shot, then absorbed in awkward chunk sizes: both must give the vector.
+    template <typename Sponge, size_t N>
+    void checkDigests(const Vector (&vectors)[N]) {
+        for (const Vector& v : vectors) {
+            const std::vector<uint8_t> data = message(v.length);
+            std::array<uint8_t, Sponge::DIGESTSIZE> digest;
+            keccak_detail::oneShot<Sponge>(data.data(), data.size(), digest.data(), digest.size());
+            CHECK_EQ_STR(test::toHex(digest.data(), digest.size()), v.expected);
+
+            for (size_t chunk : { size_t(1), size_t(7), size_t(64), Sponge::RATE - 1 }) {
+                Sponge sponge;
+                for (size_t at = 0; at < data.size(); at += chunk) {
+                    sponge.update(data.data() + at, std::min(chunk, data.size() - at));
+                }
+                sponge.final(digest.data());
+                CHECK_EQ_STR(test::toHex(digest.data(), digest.size()), v.expected);
+            }
+        }
+    }
+
+    // The window around the first squeeze permutation, produced in one call and in small pieces.
+    template <typename Sponge, size_t N>
+    void checkXof(const Vector (&vectors)[N]) {
+        constexpr size_t rate = Sponge::RATE;
+        for (const Vector& v : vectors) {
+            const std::vector<uint8_t> data = message(v.length);
+            std::vector<uint8_t> whole(rate + 16);
+            keccak_detail::oneShot<Sponge>(data.data(), data.size(), whole.data(), whole.size());
+            CHECK_EQ_STR(test::toHex(whole.data() + rate - 16, 32), v.expected);
+
+            Sponge sponge;
+            sponge.update(data.data(), data.size());
+            std::vector<uint8_t> pieces(whole.size());
+            for (size_t at = 0; at < pieces.size(); at += 5) {
+                sponge.squeeze(pieces.data() + at, std::min<size_t>(5, pieces.size() - at));
+            }
+            CHECK(pieces == whole);
+        }
+    }
+
+    void checkKeccak256() {
+        checkDigests<Keccak256Sponge>(KECCAK256);
+        for (const Vector& v : KECCAK256) {
+            const std::vector<uint8_t> data = message(v.length);
+            uint8_t digest[32];
+            keccak256(data.data(), data.size(), digest);
+            CHECK_EQ_STR(test::toHex(digest, 32), v.expected);
+
+            Keccak256 keccak;
+            keccak.Update(data.data(), data.size() / 2);
+            keccak.Update(data.data() + data.size() / 2, data.size() - data.size() / 2);
+            keccak.Final(digest);
+            CHECK_EQ_STR(test::toHex(digest, 32), v.expected);
+
+            // 11 copies: one 8-way group, then a 4-way group or the scalar tail, depending on the level.
+            constexpr size_t count = 11;
+            const uint8_t* messages[count];
+            uint8_t outputs[count][32];
+            uint8_t* digests[count];
+            for (size_t i = 0; i < count; ++i) {
+                messages[i] = data.data();
+                digests[i] = outputs[i];
+            }
+            keccak256MultiBuffer(messages, data.size(), digests, count);
+            for (size_t i = 0; i < count; ++i) {
+                CHECK_EQ_STR(test::toHex(outputs[i], 32), v.expected);
+            }
+        }
+
+        // The fixed-length path used for addresses (64-byte keys) and checksums (40 characters).
+        const std::vector<uint8_t> data = message(64);
+        uint8_t fixed[32];
+        uint8_t reference[32];
+        keccak256Fixed<64>(data.data(), fixed);
+        keccak256(data.data(), 64, reference);
+        CHECK(test::toHex(fixed, 32) == test::toHex(reference, 32));
+        keccak256Fixed<40>(data.data(), fixed);
+        keccak256(data.data(), 40, reference);
+        CHECK(test::toHex(fixed, 32) == test::toHex(reference, 32));
+    }
+
+} // namespace
+
+int main() {
+    checkKeccak256();
+    checkDigests<Sha3_224>(SHA3_224);
+    checkDigests<Sha3_256>(SHA3_256);
+    checkDigests<Sha3_384>(SHA3_384);
+    checkDigests<Sha3_512>(SHA3_512);
+    checkXof<Shake128>(SHAKE128);
+    checkXof<Shake256>(SHAKE256);
+    return test::summary("keccak_test");
+}
@@ -0,0 +1,98 @@
+// Known-answer tests for Solidity storage-slot derivation and word parsing.
+//
+// Expected slots were computed independently (pycryptodome Keccak-256 and Python integers
+// for the mod 2^256 array arithmetic).
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../src/eth/storage_slots.h"
+#include "test.h"
+
+namespace {
+
+    std::string hex(const eth::Word& word) {
+        return test::toHex(word.data(), word.size());
+    }
+
+    eth::Word word(const char* text) {
+        eth::Word out;
+        CHECK(eth::parseWord(text, out));
+        return out;
+    }
+
+    void checkSlots() {
+        // balances[0x5aAe...] for a mapping at slot 0; a 40-digit address parses to its key encoding.
+        CHECK_EQ_STR(hex(eth::mappingSlot(word("0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAed"), eth::toWord(0))),
+                     "8c91756929b31621788f506e8cf1c34326cd9cdef5119070f07e9d944585d0a1");
+        CHECK_EQ_STR(hex(eth::mappingSlot(eth::toWord(1), eth::toWord(2))),
+                     "e90b7bceb6e7df5418fb78d8ee546e97c83a08bbccc01a0644d599ccd2a7c2e0");
+
+        // m[7][0xdead] for a nested mapping at slot 3.
+        const eth::Word keys[] = { eth::toWord(7), eth::toWord(0xdead) };
+        CHECK_EQ_STR(hex(eth::nestedMappingSlot(keys, eth::toWord(3))),
+                     "e9b90fbb001b643b4b6dc53f41504bc1c72d9c106d45b67ae5a390548223065d");
+
+        CHECK_EQ_STR(hex(eth::arrayDataSlot(eth::toWord(2))),
+                     "405787fa12a823e0f2b7631cc41b3ba8828b3321ca811111fa75cd3aa3bb5ace");
+        CHECK_EQ_STR(hex(eth::arrayElementSlot(eth::toWord(2), 5, 3)),
+                     "405787fa12a823e0f2b7631cc41b3ba8828b3321ca811111fa75cd3aa3bb5add");
+        // index 2^256 - 1 wraps to one slot before the data slot.
+        eth::Word last;
+        last.fill(0xff);
+        CHECK_EQ_STR(hex(eth::arrayElementSlot(eth::toWord(2), last)),
+                     "405787fa12a823e0f2b7631cc41b3ba8828b3321ca811111fa75cd3aa3bb5acd");
+    }
+
+    void checkLargeMultiply() {
+        // (2^200 + 12345) * (2^64 - 1) carries through every 64-bit lane and wraps.
+        eth::Word index = eth::toWord(12345);
+        index[6] = 1; // + 2^200
+        CHECK_EQ_STR(hex(eth::arrayElementSlot(eth::toWord(2), index, ~uint64_t(0))),
+                     "405787fa12a822e0f2b7631cc41b3ba8828b3321ca81414afa75cd3aa3bb2a95");
+    }
+
+    void checkBatch() {
+        constexpr size_t count = 1000; // several grains and an 8-way remainder
+        std::vector<eth::Word> keys(count);
+        for (size_t i = 0; i < count; ++i) {
+            keys[i] = eth::toWord(i * 2654435761u);
+        }
+        const eth::Word slot = eth::toWord(9);
+        std::vector<eth::Word> out(count);
+        eth::mappingSlots(slot, keys, out);
+        std::vector<eth::Word> elements(count);
+        eth::arrayElementSlots(slot, keys, elements, 2);
+        for (size_t i = 0; i < count; ++i) {
+            CHECK(out[i] == eth::mappingSlot(keys[i], slot));
+            CHECK(elements[i] == eth::arrayElementSlot(slot, keys[i], 2));
+        }
+    }
+
+    void checkParseWord() {
+        eth::Word out;
+        CHECK(eth::parseWord("12345", out) && out == eth::toWord(12345));
+        CHECK(eth::parseWord("0x3039", out) && out == eth::toWord(12345));
+        CHECK(eth::parseWord("0X3039", out) && out == eth::toWord(12345));
+        // 2^256 - 1 fits in decimal; 2^256 does not.
+        CHECK(eth::parseWord("115792089237316195423570985008687907853269984665640564039457584007913129639935", out));
+        CHECK(hex(out) == std::string(64, 'f'));
+        CHECK(!eth::parseWord("115792089237316195423570985008687907853269984665640564039457584007913129639936", out));
+        CHECK(!eth::parseWord("0x" + std::string(65, '1'), out));
+        CHECK(!eth::parseWord("", out));
+        CHECK(!eth::parseWord("12a", out));
+        CHECK(!eth::parseWord("0x12g4", out));
+        CHECK(!eth::parseWord("-1", out));
+    }
+
+} // namespace
+
+int main() {
+    checkSlots();
+    checkLargeMultiply();
+    checkBatch();
+    checkParseWord();
+    return test::summary("storage_slots_test");
+}
@@ -0,0 +1,87 @@
+// test.h - Minimal check helpers shared by the known-answer tests
+//
+// Each test is a standalone program: checks print the failing expression and
+// keep going, and main() returns test::summary(), which is non-zero if any
+// check failed. build.sh builds every test and runs it once per CPU dispatch
+// level (KECCAK_CPU_LEVEL), so the scalar and every SIMD kernel see the same
+// vectors.
+
+#ifndef TESTS_TEST_H
+#define TESTS_TEST_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../src/cpu/cpu_dispatch.h"
+
+namespace test {
+
+    inline int& failures() noexcept {
+        static int count = 0;
+        return count;
+    }
+
+    inline bool check(bool ok, const char* expression, const char* file, int line) {
+        if (!ok) {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+            ++failures();
+        }
+        return ok;
+    }
+
+    inline bool checkEqual(std::string_view actual, std::string_view expected, const char* expression,
+                           const char* file, int line) {
+        if (actual != expected) {
+            std::fprintf(stderr, "%s:%d: %s\n  expected: %.*s\n  actual:   %.*s\n", file, line, expression,
+                         static_cast<int>(expected.size()), expected.data(),
+                         static_cast<int>(actual.size()), actual.data());
+            ++failures();
+            return false;
+        }
+        return true;
+    }
+
+    // Lowercase hex of a byte range.
+    inline std::string toHex(const uint8_t* data, size_t size) {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string text(2 * size, '0');
+        for (size_t i = 0; i < size; ++i) {
+            text[2 * i] = digits[data[i] >> 4];
+            text[2 * i + 1] = digits[data[i] & 0x0F];
+        }
+        return text;
+    }
+
+    // Bytes of a lowercase or uppercase hex string (test vectors only; no validation).
+    inline std::vector<uint8_t> fromHex(std::string_view hex) {
+        auto nibble = [](char c) {
+            return static_cast<uint8_t>(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+        };
+        std::vector<uint8_t> bytes(hex.size() / 2);
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            bytes[i] = static_cast<uint8_t>(nibble(hex[2 * i]) << 4 | nibble(hex[2 * i + 1]));
+        }
+        return bytes;
+    }
+
+    // Print the result line and return the process exit code.
+    inline int summary(const char* name) {
+        const char* level = cpu::levelName(cpu::levelCap());
+        if (failures() != 0) {
+            std::fprintf(stderr, "%s [%s]: %d check(s) failed\n", name, level, failures());
+            return 1;
+        }
+        std::printf("%s [%s]: ok\n", name, level);
+        return 0;
+    }
+
+} // namespace test
+
+#define CHECK(condition) ::test::check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_EQ_STR(actual, expected) ::test::checkEqual((actual), (expected), #actual, __FILE__, __LINE__)
+
+#endif // TESTS_TEST_H
@@ -0,0 +1,118 @@
+// Tests for the watchlist: exact membership behind the Bloom prefilter, batch matching and
+// the derive-and-match helpers, checked against a sorted reference set.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/eth/address_batch.h"
+#include "../src/eth/watchlist.h"
+#include "test.h"
+
+namespace {
+
+    // Deterministic, well-spread 64-byte "public keys".
+    std::vector<eth::Byte> makeKeys(size_t count) {
+        std::vector<eth::Byte> keys(64 * count);
+        for (size_t i = 0; i < count; ++i) {
+            const uint64_t seed = i;
+            keccak256(reinterpret_cast<const uint8_t*>(&seed), sizeof(seed), keys.data() + 64 * i);
+            keccak256(keys.data() + 64 * i, 32, keys.data() + 64 * i + 32);
+        }
+        return keys;
+    }
+
+    void checkMembership() {
+        constexpr size_t count = 3000;
+        const std::vector<eth::Byte> keys = makeKeys(count);
+        std::vector<eth::Address> addresses(count);
+        eth::deriveAddresses(keys.data(), 64, count, addresses.data()->data());
+
+        // Every third address is watched, plus a duplicate and the zero address.
+        std::vector<eth::Address> watched;
+        for (size_t i = 0; i < count; i += 3) {
+            watched.push_back(addresses[i]);
+        }
+        watched.push_back(addresses[0]);
+        watched.push_back(eth::Address{});
+        const eth::Watchlist watchlist(watched);
+        CHECK(watchlist.size() == count / 3 + 1);
+        CHECK(watchlist.contains(eth::Address{}));
+
+        std::vector<eth::Address> reference = watched;
+        std::sort(reference.begin(), reference.end());
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < count; ++i) {
+            const bool member = std::binary_search(reference.begin(), reference.end(), addresses[i]);
+            CHECK(watchlist.contains(addresses[i]) == member);
+            if (member) {
+                expected.push_back(i);
+            }
+        }
+
+        std::vector<size_t> hits(count);
+        const size_t found = watchlist.matchBatch(addresses.data()->data(), count, hits.data());
+        hits.resize(found);
+        CHECK(hits == expected);
+
+        // Derive-and-match from records, and match of already-derived addresses, on a 3-worker pool.
+        eth::ThreadPool pool(eth::ThreadPool::Options{ 3, false });
+        std::vector<eth::WatchlistMatch> fromRecords;
+        std::vector<eth::WatchlistMatch> fromAddresses;
+        CHECK(eth::findWatchedAddresses(keys.data(), 64, count, watchlist, fromRecords, pool) == expected.size());
+        CHECK(eth::findWatchedAddresses(addresses, watchlist, fromAddresses, pool) == expected.size());
+        for (size_t m = 0; m < expected.size() && m < fromRecords.size() && m < fromAddresses.size(); ++m) {
+            CHECK(fromRecords[m].index == expected[m]);
+            CHECK(fromRecords[m].address == addresses[expected[m]]);
+            CHECK(fromAddresses[m].index == expected[m]);
+            CHECK(fromAddresses[m].address == addresses[expected[m]]);
+        }
+
+        const eth::Watchlist empty;
+        CHECK(empty.empty());
+        CHECK(!empty.contains(addresses[0]));
+        CHECK(empty.matchBatch(addresses.data()->data(), count, hits.data()) == 0);
+    }
+
+    void checkParsing() {
+        const eth::Watchlist watchlist = eth::Watchlist::fromHexLines(
+            "0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAed\n"
+            "\n"
+            "fb6916095ca1df60bb79ce92ce3ea74c37c5d359\r\n"
+            "0XDBF03B407C01E7CD3CBEA99509D93F8DDDC8C6FB");
+        CHECK(watchlist.size() == 3);
+        eth::Address address;
+        eth::Address::parse("0xfB6916095ca1df60bB79Ce92cE3Ea74c37c5d359", address);
+        CHECK(watchlist.contains(address));
+        eth::Address::parse("0xD1220A0cf47c7B9Be7A2E6BA89F429762e7b9aDb", address);
+        CHECK(!watchlist.contains(address));
+
+        bool threw = false;
+        try {
+            eth::Watchlist::fromHexLines("0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAed\nnot-an-address\n");
+        } catch (const std::invalid_argument& e) {
+            threw = std::string(e.what()).find("line 2") != std::string::npos;
+        }
+        CHECK(threw);
+
+        const eth::Byte binary[40] = { 1, 2, 3 };
+        CHECK(eth::Watchlist::fromBinary(binary, sizeof(binary)).size() == 2);
+        threw = false;
+        try {
+            eth::Watchlist::fromBinary(binary, 39);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+} // namespace
+
+int main() {
+    checkMembership();
+    checkParsing();
+    return test::summary("watchlist_test");
+}